@@ -0,0 +1,44 @@
+/**
+ * Aligned heap allocation for SIMD friendly arrays
+ * C11 aligned_alloc is missing on MSVC, so use _aligned_malloc there
+ */
+#pragma once
+#include <stdlib.h> // free, aligned_alloc
+
+#if _MSC_VER
+	#include <malloc.h> // _aligned_malloc, _aligned_free
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+#define MEM_ALIGNMENT 64 // a cache line, also enough for any SSE/AVX/AVX-512 load
+
+
+// allocates @size bytes aligned to @alignment (a power of 2), free with mem_aligned_free()
+static inline void* mem_aligned_alloc(size_t size, size_t alignment)
+{
+#if _MSC_VER
+	return _aligned_malloc(size ? size : 1, alignment);
+#else
+	size_t rounded = (size + alignment - 1) & ~(alignment - 1); // aligned_alloc wants a multiple
+	return aligned_alloc(alignment, rounded ? rounded : alignment);
+#endif
+}
+
+
+static inline void mem_aligned_free(void* ptr)
+{
+#if _MSC_VER
+	_aligned_free(ptr);
+#else
+	free(ptr);
+#endif
+}
+
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,146 @@
+/**
+ * A handful of portable atomic operations for the course examples
+ * GCC/Clang use the __atomic builtins, MSVC uses the Interlocked* intrinsics
+ * (MSVC's C compiler has no usable <stdatomic.h>)
+ */
+#pragma once
+
+#if _MSC_VER
+	#include <intrin.h>
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+// atomically adds @value to *@ptr and returns the previous value
+static inline int atomic_fetch_add_int(volatile int* ptr, int value)
+{
+#if _MSC_VER
+	return _InterlockedExchangeAdd((volatile long*)ptr, value);
+#else
+	return __atomic_fetch_add(ptr, value, __ATOMIC_ACQ_REL);
+#endif
+}
+
+
+static inline int atomic_load_int(const volatile int* ptr)
+{
+#if _MSC_VER
+	int value = *ptr; // plain loads are acquire on x86 and volatile on MSVC
+	_ReadWriteBarrier();
+	return value;
+#else
+	return __atomic_load_n(ptr, __ATOMIC_ACQUIRE);
+#endif
+}
+
+
+static inline void atomic_store_int(volatile int* ptr, int value)
+{
+#if _MSC_VER
+	_ReadWriteBarrier();
+	*ptr = value;
+#else
+	__atomic_store_n(ptr, value, __ATOMIC_RELEASE);
+#endif
+}
+
+
+// compare-and-swap: if *@ptr == expected, stores desired; returns the previous value
+static inline int atomic_cas_int(volatile int* ptr, int expected, int desired)
+{
+#if _MSC_VER
+	return _InterlockedCompareExchange((volatile long*)ptr, desired, expected);
+#else
+	__atomic_compare_exchange_n(ptr, &expected, desired, 0, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE);
+	return expected;
+#endif
+}
+
+
+static inline unsigned atomic_load_uint(const volatile unsigned* ptr)
+{
+#if _MSC_VER
+	unsigned value = *ptr;
+	_ReadWriteBarrier();
+	return value;
+#else
+	return __atomic_load_n(ptr, __ATOMIC_ACQUIRE);
+#endif
+}
+
+
+static inline void atomic_store_uint(volatile unsigned* ptr, unsigned value)
+{
+#if _MSC_VER
+	_ReadWriteBarrier();
+	*ptr = value;
+#else
+	__atomic_store_n(ptr, value, __ATOMIC_RELEASE);
+#endif
+}
+
+
+static inline unsigned char atomic_load_u8(const volatile unsigned char* ptr)
+{
+#if _MSC_VER
+	unsigned char value = *ptr;
+	_ReadWriteBarrier();
+	return value;
+#else
+	return __atomic_load_n(ptr, __ATOMIC_ACQUIRE);
+#endif
+}
+
+
+static inline void atomic_store_u8(volatile unsigned char* ptr, unsigned char value)
+{
+#if _MSC_VER
+	_ReadWriteBarrier();
+	*ptr = value;
+#else
+	__atomic_store_n(ptr, value, __ATOMIC_RELEASE);
+#endif
+}
+
+
+static inline void* atomic_load_ptr(void* const volatile* ptr)
+{
+#if _MSC_VER
+	void* value = *ptr;
+	_ReadWriteBarrier();
+	return value;
+#else
+	return __atomic_load_n(ptr, __ATOMIC_ACQUIRE);
+#endif
+}
+
+
+static inline void atomic_store_ptr(void* volatile* ptr, void* value)
+{
+#if _MSC_VER
+	_ReadWriteBarrier();
+	*ptr = value;
+#else
+	__atomic_store_n(ptr, value, __ATOMIC_RELEASE);
+#endif
+}
+
+
+// compare-and-swap for pointers: returns the previous value of *@ptr
+static inline void* atomic_cas_ptr(void* volatile* ptr, void* expected, void* desired)
+{
+#if _MSC_VER
+	return _InterlockedCompareExchangePointer(ptr, desired, expected);
+#else
+	__atomic_compare_exchange_n(ptr, &expected, desired, 0, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE);
+	return expected;
+#endif
+}
+
+
+#ifdef __cplusplus
+}
+#endif
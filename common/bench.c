@@ -0,0 +1,438 @@
+/**
+ * Small benchmark harness shared by the course examples
+ * Uses C99 dialect, so compile with -std=gnu99 or -std=c99
+ */
+#if __linux__ && !defined(_GNU_SOURCE)
+	#define _GNU_SOURCE // syscall() with -std=c11
+#endif
+#include "bench.h"
+#include "timer.h"  // timer_now
+#include <stdio.h>  // FILE, fprintf
+#include <stdlib.h> // getenv, malloc, qsort, strtod
+#include <string.h> // strcmp, strncmp, strchr, strerror
+#include <stdint.h> // uint64_t
+
+#if __linux__
+	#include <errno.h>
+	#include <linux/perf_event.h> // perf_event_attr, PERF_COUNT_HW_*
+	#include <sys/ioctl.h>        // ioctl
+	#include <sys/syscall.h>      // __NR_perf_event_open
+	#include <unistd.h>           // syscall, read, close
+	#define BENCH_PERF 1
+#else
+	#define BENCH_PERF 0
+#endif
+
+
+#define BENCH_SAMPLE_SECONDS 0.002 // calls are batched until a sample takes this long
+#define BENCH_WARMUP_SECONDS 0.05
+#define BENCH_MAX_SECONDS    2.0   // slow benchmarks stop early, after at least 5 samples
+#define BENCH_COUNTERS       4     // cycles, instructions, cache misses, branch misses
+
+typedef enum _bench_format { FORMAT_TEXT, FORMAT_CSV, FORMAT_JSON } bench_format;
+
+static struct {
+	const char*  program;
+	bench_format format;
+	FILE*        out;
+	int          samples;
+	double       threshold;  // fraction, 0.1 = 10% slower
+	char*        baseline;   // contents of BENCH_BASELINE, NULL if none
+	int          results;
+	int          regressions;
+	int          leader;     // perf group leader fd, -1 if counters are off
+	int          fds[BENCH_COUNTERS];
+	int          slots[BENCH_COUNTERS]; // index of each counter in the group read, -1 if missing
+	int          opened;
+	char         counterNote[96];
+} bench = { "", FORMAT_TEXT, NULL, 30, 0.1, NULL, 0, 0, -1 };
+
+
+
+
+
+
+/**
+ * Hardware counters
+ */
+#if BENCH_PERF
+static int perf_open(uint64_t config, int group)
+{
+	struct perf_event_attr attr;
+	memset(&attr, 0, sizeof attr);
+	attr.size = sizeof attr;
+	attr.type = PERF_TYPE_HARDWARE;
+	attr.config = config;
+	attr.disabled = group == -1; // the members follow the leader
+	attr.exclude_kernel = 1;     // allowed with perf_event_paranoid <= 2
+	attr.exclude_hv = 1;
+	attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+	return (int)syscall(__NR_perf_event_open, &attr, 0, -1, group, 0);
+}
+#endif
+
+
+static void counters_open(void)
+{
+	bench.leader = -1;
+	bench.opened = 0;
+	for (int i = 0; i < BENCH_COUNTERS; ++i)
+		bench.fds[i] = bench.slots[i] = -1;
+#if BENCH_PERF
+	static const uint64_t events[BENCH_COUNTERS] = {
+		PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS,
+		PERF_COUNT_HW_CACHE_MISSES, PERF_COUNT_HW_BRANCH_MISSES
+	};
+	int error = 0;
+	for (int i = 0; i < BENCH_COUNTERS; ++i)
+	{
+		int fd = perf_open(events[i], bench.leader);
+		if (fd < 0) // some VMs only expose part of the PMU, keep what works
+		{
+			error = errno;
+			continue;
+		}
+		if (bench.leader < 0)
+			bench.leader = fd;
+		bench.fds[i] = fd;
+		bench.slots[i] = bench.opened++;
+	}
+	if (bench.leader < 0)
+		snprintf(bench.counterNote, sizeof bench.counterNote, "off (perf_event_open: %s)", strerror(error));
+	else if (bench.opened < BENCH_COUNTERS)
+		snprintf(bench.counterNote, sizeof bench.counterNote, "partial (%d of %d)", bench.opened, BENCH_COUNTERS);
+	else
+		snprintf(bench.counterNote, sizeof bench.counterNote, "on");
+#else
+	snprintf(bench.counterNote, sizeof bench.counterNote, "off (Linux only)");
+#endif
+}
+
+
+static void counters_close(void)
+{
+#if BENCH_PERF
+	for (int i = 0; i < BENCH_COUNTERS; ++i)
+		if (bench.fds[i] >= 0)
+			close(bench.fds[i]);
+#endif
+	bench.leader = -1;
+}
+
+
+static void counters_start(void)
+{
+#if BENCH_PERF
+	if (bench.leader < 0)
+		return;
+	ioctl(bench.leader, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+	ioctl(bench.leader, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+#endif
+}
+
+
+// reads the counters since counters_start(), returns 0 if there are none
+static int counters_stop(double values[BENCH_COUNTERS])
+{
+#if BENCH_PERF
+	if (bench.leader < 0)
+		return 0;
+	ioctl(bench.leader, PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+	uint64_t data[3 + BENCH_COUNTERS]; // nr, time enabled, time running, values
+	ssize_t want = (ssize_t)sizeof(uint64_t) * (3 + bench.opened);
+	if (read(bench.leader, data, sizeof data) < want || data[2] == 0)
+		return 0;
+	// if other users of the PMU pushed the group out for a while, extrapolate
+	double scale = (double)data[1] / (double)data[2];
+	for (int i = 0; i < BENCH_COUNTERS; ++i)
+		values[i] = bench.slots[i] < 0 ? -1.0 : (double)data[3 + bench.slots[i]] * scale;
+	return 1;
+#else
+	(void)values;
+	return 0;
+#endif
+}
+
+
+
+
+
+
+/**
+ * Baseline: a csv written earlier with BENCH_FORMAT=csv
+ */
+static char* read_file(const char* path)
+{
+	FILE* f = fopen(path, "rb");
+	if (!f)
+		return NULL;
+	fseek(f, 0, SEEK_END);
+	long size = ftell(f);
+	fseek(f, 0, SEEK_SET);
+	char* text = size >= 0 ? malloc((size_t)size + 1) : NULL;
+	if (text)
+		text[fread(text, 1, (size_t)size, f)] = 0;
+	fclose(f);
+	return text;
+}
+
+
+// median seconds of program,name in the baseline, 0 if it isn't there
+static double baseline_median(const char* name)
+{
+	size_t plen = strlen(bench.program), nlen = strlen(name);
+	for (const char* line = bench.baseline; line && *line; )
+	{
+		const char* end = strchr(line, '\n');
+		if (!end)
+			end = line + strlen(line);
+		if (strncmp(line, bench.program, plen) == 0 && line[plen] == ',' &&
+		    strncmp(line + plen + 1, name, nlen) == 0 && line[plen + 1 + nlen] == ',')
+		{
+			const char* field = line + plen + 1 + nlen + 1; // samples,calls,median_ns,...
+			for (int skip = 0; skip < 2 && field; ++skip)
+				if ((field = strchr(field, ',')) != NULL)
+					++field;
+			return field && field < end ? strtod(field, NULL) * 1e-9 : 0.0;
+		}
+		line = *end ? end + 1 : end;
+	}
+	return 0.0;
+}
+
+
+
+
+
+
+/**
+ * Output
+ */
+static const char* format_time(char* buf, double seconds)
+{
+	if      (seconds < 1e-6) sprintf(buf, "%.2fns", seconds * 1e9);
+	else if (seconds < 1e-3) sprintf(buf, "%.2fus", seconds * 1e6);
+	else if (seconds < 1.0)  sprintf(buf, "%.2fms", seconds * 1e3);
+	else                     sprintf(buf, "%.2fs",  seconds);
+	return buf;
+}
+
+
+static void print_counter(double value)
+{
+	if (value < 0.0) fprintf(bench.out, " %10s", "-");
+	else             fprintf(bench.out, " %10.4g", value);
+}
+
+
+static void csv_counter(double value)
+{
+	if (value < 0.0) fprintf(bench.out, ",");
+	else             fprintf(bench.out, ",%.0f", value);
+}
+
+
+static void json_number(const char* key, double value)
+{
+	if (value < 0.0) fprintf(bench.out, ",\"%s\":null", key);
+	else             fprintf(bench.out, ",\"%s\":%.6g", key, value);
+}
+
+
+static void write_result(const bench_result* r)
+{
+	double mbps = r->bytes > 0.0 ? r->bytes / r->median * 1e-6 : 0.0;
+	double change = r->baseline > 0.0 ? r->median / r->baseline - 1.0 : 0.0;
+	char t1[32], t2[32];
+	switch (bench.format)
+	{
+	case FORMAT_TEXT:
+		fprintf(bench.out, "%-34s %10s %10s", r->name, format_time(t1, r->median), format_time(t2, r->p99));
+		if (mbps > 0.0) fprintf(bench.out, " %10.1f", mbps);
+		else            fprintf(bench.out, " %10s", "-");
+		print_counter(r->cycles);
+		print_counter(r->instructions);
+		if (r->cycles > 0.0 && r->instructions >= 0.0) fprintf(bench.out, " %5.2f", r->instructions / r->cycles);
+		else                                           fprintf(bench.out, " %5s", "-");
+		print_counter(r->cacheMisses);
+		print_counter(r->branchMisses);
+		if (r->baseline > 0.0)
+			fprintf(bench.out, " %+7.1f%%%s", change * 100.0, r->regressed ? " REGRESSED" : "");
+		fprintf(bench.out, "\n");
+		break;
+	case FORMAT_CSV:
+		fprintf(bench.out, "%s,%s,%d,%lld,%.3f,%.3f,%.3f,%.3f", bench.program, r->name, r->samples,
+		        r->calls, r->median * 1e9, r->p99 * 1e9, r->min * 1e9, mbps);
+		csv_counter(r->cycles); // empty if unavailable
+		csv_counter(r->instructions);
+		csv_counter(r->cacheMisses);
+		csv_counter(r->branchMisses);
+		fprintf(bench.out, "\n");
+		break;
+	case FORMAT_JSON:
+		fprintf(bench.out, "%s{\"name\":\"%s\",\"samples\":%d,\"calls\":%lld", bench.results ? "," : "",
+		        r->name, r->samples, r->calls);
+		json_number("median_ns", r->median * 1e9);
+		json_number("p99_ns", r->p99 * 1e9);
+		json_number("min_ns", r->min * 1e9);
+		if (r->bytes > 0.0) json_number("mb_per_s", mbps);
+		json_number("cycles", r->cycles);
+		json_number("instructions", r->instructions);
+		json_number("cache_misses", r->cacheMisses);
+		json_number("branch_misses", r->branchMisses);
+		if (r->baseline > 0.0)
+		{
+			json_number("baseline_ns", r->baseline * 1e9);
+			fprintf(bench.out, ",\"regressed\":%s", r->regressed ? "true" : "false");
+		}
+		fprintf(bench.out, "}");
+		break;
+	}
+	fflush(bench.out);
+}
+
+
+
+
+
+
+/**
+ * Measuring
+ */
+static int compare_doubles(const void* a, const void* b)
+{
+	double x = *(const double*)a, y = *(const double*)b;
+	return (x > y) - (x < y);
+}
+
+
+static double median_of(double* values, int count) // sorts @values
+{
+	qsort(values, count, sizeof(double), compare_doubles);
+	return count % 2 ? values[count / 2] : 0.5 * (values[count / 2 - 1] + values[count / 2]);
+}
+
+
+void bench_begin(const char* program)
+{
+	const char* format = getenv("BENCH_FORMAT");
+	const char* out = getenv("BENCH_OUT");
+	const char* samples = getenv("BENCH_SAMPLES");
+	const char* baseline = getenv("BENCH_BASELINE");
+	const char* threshold = getenv("BENCH_THRESHOLD");
+
+	bench.program = program;
+	bench.format = FORMAT_TEXT;
+	if (format && strcmp(format, "csv") == 0)  bench.format = FORMAT_CSV;
+	if (format && strcmp(format, "json") == 0) bench.format = FORMAT_JSON;
+	bench.samples = samples && atoi(samples) > 0 ? atoi(samples) : 30;
+	bench.threshold = threshold ? atof(threshold) / 100.0 : 0.1;
+	bench.results = 0;
+	bench.regressions = 0;
+
+	// appended, so several programs can collect their results in one file
+	bench.out = out && *out ? fopen(out, "a") : NULL;
+	if (!bench.out)
+		bench.out = stdout;
+	bench.baseline = baseline && *baseline ? read_file(baseline) : NULL;
+	if (baseline && *baseline && !bench.baseline)
+		fprintf(stderr, "BENCH_BASELINE=%s can't be read, not comparing\n", baseline);
+	counters_open();
+
+	switch (bench.format)
+	{
+	case FORMAT_TEXT:
+		fprintf(bench.out, "%s: median of up to %d samples, hardware counters %s, per call:\n",
+		        program, bench.samples, bench.counterNote);
+		fprintf(bench.out, "%-34s %10s %10s %10s %10s %10s %5s %10s %10s%s\n", "name", "median", "p99", "MB/s",
+		        "cycles", "instrs", "IPC", "cache-miss", "br-miss", bench.baseline ? "  vs base" : "");
+		break;
+	case FORMAT_CSV:
+		fseek(bench.out, 0, SEEK_END);
+		if (bench.out == stdout || ftell(bench.out) <= 0) // stdout can't tell, always gets a header
+			fprintf(bench.out, "program,name,samples,calls,median_ns,p99_ns,min_ns,mb_per_s,"
+			                   "cycles,instructions,cache_misses,branch_misses\n");
+		break;
+	case FORMAT_JSON: // one line per program (JSON Lines)
+		fprintf(bench.out, "{\"program\":\"%s\",\"counters\":%s,\"results\":[", program,
+		        bench.leader >= 0 ? "true" : "false");
+		break;
+	}
+}
+
+
+bench_result bench_run(const char* name, bench_fn fn, void* arg, double bytes)
+{
+	bench_result r;
+	memset(&r, 0, sizeof r);
+	r.name = name;
+	r.bytes = bytes;
+
+	// warm-up: caches, branch predictors, page faults and the clock speed settle
+	// and the time per call tells how many calls make up one sample
+	int warmups = 0;
+	double start = timer_now(), elapsed;
+	do {
+		fn(arg);
+		++warmups;
+		elapsed = timer_now() - start;
+	} while (warmups < 3 || elapsed < BENCH_WARMUP_SECONDS);
+	double perCall = elapsed / warmups;
+	r.calls = perCall >= BENCH_SAMPLE_SECONDS ? 1 : (long long)(BENCH_SAMPLE_SECONDS / perCall) + 1;
+
+	double* times = malloc(sizeof(double) * bench.samples * (1 + BENCH_COUNTERS));
+	double* counts = times + bench.samples; // [counter][sample]
+	int counted = 0;
+	start = timer_now();
+	for (r.samples = 0; r.samples < bench.samples; ++r.samples)
+	{
+		if (r.samples >= 5 && timer_now() - start > BENCH_MAX_SECONDS)
+			break;
+		double values[BENCH_COUNTERS];
+		counters_start();
+		double t0 = timer_now();
+		for (long long c = 0; c < r.calls; ++c)
+			fn(arg);
+		double t1 = timer_now();
+		if (counters_stop(values))
+		{
+			for (int i = 0; i < BENCH_COUNTERS; ++i)
+				counts[i * bench.samples + counted] = values[i] / r.calls;
+			++counted;
+		}
+		times[r.samples] = (t1 - t0) / r.calls;
+	}
+
+	r.median = median_of(times, r.samples);
+	r.p99 = times[(r.samples * 99 + 99) / 100 - 1]; // nearest rank, times are sorted now
+	r.min = times[0];
+	double* counters[BENCH_COUNTERS] = { &r.cycles, &r.instructions, &r.cacheMisses, &r.branchMisses };
+	for (int i = 0; i < BENCH_COUNTERS; ++i)
+		*counters[i] = counted && bench.slots[i] >= 0 ? median_of(counts + i * bench.samples, counted) : -1.0;
+	free(times);
+
+	r.baseline = baseline_median(name);
+	r.regressed = r.baseline > 0.0 && r.median > r.baseline * (1.0 + bench.threshold);
+	bench.regressions += r.regressed;
+
+	write_result(&r);
+	++bench.results;
+	return r;
+}
+
+
+int bench_end(void)
+{
+	if (bench.format == FORMAT_JSON)
+		fprintf(bench.out, "]}\n");
+	else if (bench.format == FORMAT_TEXT && bench.regressions)
+		fprintf(bench.out, "%d regression(s) over %.0f%% against the baseline\n",
+		        bench.regressions, bench.threshold * 100.0);
+	if (bench.out != stdout)
+		fclose(bench.out);
+	bench.out = NULL;
+	free(bench.baseline);
+	bench.baseline = NULL;
+	counters_close();
+	return bench.regressions;
+}
@@ -0,0 +1,56 @@
+/**
+ * Small benchmark harness shared by the course examples
+ *
+ * bench_run() warms a function up, calibrates how many calls make one ~2ms sample,
+ * then times a series of samples and reports the median, p99 and minimum per call.
+ * On Linux it also counts cycles, instructions, cache misses and branch misses with
+ * perf_event_open, if the kernel permits it (perf_event_paranoid <= 2).
+ *
+ * Configuration comes from the environment, so `make bench` needs no extra arguments:
+ *   BENCH_FORMAT=text|csv|json   output format (text); json is one line per program
+ *   BENCH_OUT=file               append results to a file instead of stdout
+ *   BENCH_SAMPLES=n              timed samples per benchmark (30)
+ *   BENCH_BASELINE=file.csv      compare medians against an earlier csv run
+ *   BENCH_THRESHOLD=percent      slowdown that counts as a regression (10)
+ */
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+typedef void (*bench_fn)(void* arg);
+
+
+typedef struct _bench_result {
+	const char* name;
+	int       samples;
+	long long calls;        // calls of fn per sample
+	double    median;       // seconds per call
+	double    p99;
+	double    min;
+	double    bytes;        // bytes processed per call, 0 if throughput doesn't apply
+	// per call, median over the samples; < 0 if the counter isn't available
+	double    cycles;
+	double    instructions;
+	double    cacheMisses;
+	double    branchMisses;
+	double    baseline;     // baseline median, 0 if there is none
+	int       regressed;    // median is over the threshold slower than baseline
+} bench_result;
+
+
+// starts the output for @program; names identify results in baselines, avoid commas
+void bench_begin(const char* program);
+
+// measures fn(arg) and writes the result
+bench_result bench_run(const char* name, bench_fn fn, void* arg, double bytes);
+
+// finishes the output, returns the number of regressions against BENCH_BASELINE
+int bench_end(void);
+
+
+#ifdef __cplusplus
+}
+#endif
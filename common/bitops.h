@@ -0,0 +1,61 @@
+/**
+ * Portable bit scanning helpers for the course examples
+ * GCC/Clang use __builtin_ctz/clz, MSVC uses _BitScanForward/_BitScanReverse
+ */
+#pragma once
+#include <stdint.h> // uint32_t, uint64_t
+
+#if _MSC_VER
+	#include <intrin.h>
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+// index of the lowest set bit, @value must not be 0
+static inline int bit_ctz32(uint32_t value)
+{
+#if _MSC_VER
+	unsigned long index;
+	_BitScanForward(&index, value);
+	return (int)index;
+#else
+	return __builtin_ctz(value);
+#endif
+}
+
+
+// index of the lowest set bit, @value must not be 0
+static inline int bit_ctz64(uint64_t value)
+{
+#if _MSC_VER && _WIN64
+	unsigned long index;
+	_BitScanForward64(&index, value);
+	return (int)index;
+#elif _MSC_VER
+	uint32_t lo = (uint32_t)value;
+	return lo ? bit_ctz32(lo) : 32 + bit_ctz32((uint32_t)(value >> 32));
+#else
+	return __builtin_ctzll(value);
+#endif
+}
+
+
+// index of the highest set bit, @value must not be 0
+static inline int bit_log2_32(uint32_t value)
+{
+#if _MSC_VER
+	unsigned long index;
+	_BitScanReverse(&index, value);
+	return (int)index;
+#else
+	return 31 - __builtin_clz(value);
+#endif
+}
+
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,131 @@
+/**
+ * Runtime CPU feature detection for the course examples
+ */
+#include "cpu_features.h"
+#include "atomics.h" // atomic_load_int, atomic_store_int, atomic_cas_int
+#include <stdio.h>  // fprintf
+#include <stdlib.h> // getenv
+#include <string.h> // strcmp
+
+#if CPU_X86 && _MSC_VER
+	#include <intrin.h> // __cpuidex, _xgetbv
+#elif CPU_X86
+	#include <cpuid.h>  // __cpuid_count
+#endif
+
+
+static const char* level_names[CPU_LEVEL_COUNT] = { "scalar", "sse2", "avx2", "avx512" };
+
+
+const char* cpu_level_name(cpu_level level)
+{
+	return (level >= 0 && level < CPU_LEVEL_COUNT) ? level_names[level] : "unknown";
+}
+
+
+#if CPU_X86
+static void cpuid(unsigned leaf, unsigned subleaf, unsigned regs[4])
+{
+#if _MSC_VER
+	__cpuidex((int*)regs, (int)leaf, (int)subleaf);
+#else
+	__cpuid_count(leaf, subleaf, regs[0], regs[1], regs[2], regs[3]);
+#endif
+}
+
+// which register states the OS saves on context switch (XCR0)
+static unsigned long long xgetbv0(void)
+{
+#if _MSC_VER
+	return _xgetbv(0);
+#else
+	unsigned lo, hi;
+	__asm__ volatile("xgetbv" : "=a"(lo), "=d"(hi) : "c"(0));
+	return ((unsigned long long)hi << 32) | lo;
+#endif
+}
+#endif
+
+
+static cpu_level detect(void)
+{
+#if CPU_X86
+	unsigned r[4]; // eax, ebx, ecx, edx
+	cpuid(0, 0, r);
+	unsigned maxLeaf = r[0];
+
+	cpuid(1, 0, r);
+	if (!(r[3] & (1u << 26))) // edx.SSE2
+		return CPU_SCALAR;
+
+	// AVX needs the CPU to support it and the OS to save the YMM registers
+	int osxsave = (r[2] >> 27) & 1;
+	int avx     = (r[2] >> 28) & 1;
+	if (!osxsave || !avx || maxLeaf < 7)
+		return CPU_SSE2;
+	unsigned long long xcr0 = xgetbv0();
+	if ((xcr0 & 0x6) != 0x6) // XMM and YMM state
+		return CPU_SSE2;
+
+	cpuid(7, 0, r);
+	if (!(r[1] & (1u << 5))) // ebx.AVX2
+		return CPU_SSE2;
+
+	unsigned avx512 = (1u << 16) | (1u << 30) | (1u << 31); // F, BW, VL
+	if ((r[1] & avx512) != avx512 || (xcr0 & 0xE0) != 0xE0) // opmask, ZMM0-15, ZMM16-31
+		return CPU_AVX2;
+	return CPU_AVX512;
+#else
+	return CPU_SCALAR;
+#endif
+}
+
+
+cpu_level cpu_detect(void)
+{
+	// racing threads compute and store the same value, so no lock is needed
+	static volatile int detected = -1;
+	int level = atomic_load_int(&detected);
+	if (level < 0)
+	{
+		level = detect();
+		atomic_store_int(&detected, level);
+	}
+	return (cpu_level)level;
+}
+
+
+// the CPU_LEVEL warnings are printed by the first caller only
+static volatile int warned = 0;
+static int first_warning(void)
+{
+	return atomic_cas_int(&warned, 0, 1) == 0;
+}
+
+
+cpu_level cpu_active_level(void)
+{
+	cpu_level level = cpu_detect();
+	const char* forced = getenv("CPU_LEVEL");
+	if (!forced || !*forced)
+		return level;
+
+	for (int i = 0; i < CPU_LEVEL_COUNT; ++i)
+	{
+		if (strcmp(forced, level_names[i]) == 0)
+		{
+			if (i > (int)level)
+			{
+				if (first_warning())
+					fprintf(stderr, "CPU_LEVEL=%s is not supported by this CPU, using %s\n",
+					        forced, level_names[level]);
+				return level;
+			}
+			return (cpu_level)i;
+		}
+	}
+	if (first_warning())
+		fprintf(stderr, "CPU_LEVEL=%s is unknown (scalar, sse2, avx2, avx512), using %s\n",
+		        forced, level_names[level]);
+	return level;
+}
@@ -0,0 +1,39 @@
+/**
+ * Runtime CPU feature detection for the course examples
+ * The CPU is queried once with cpuid/xgetbv; the CPU_LEVEL environment variable
+ * (scalar, sse2, avx2, avx512) can lower the level used, e.g. for testing
+ */
+#pragma once
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+	#define CPU_X86 1
+#else
+	#define CPU_X86 0
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+typedef enum _cpu_level {
+	CPU_SCALAR = 0, // plain C, no SIMD
+	CPU_SSE2   = 1, // x86-64 baseline
+	CPU_AVX2   = 2, // Haswell and later
+	CPU_AVX512 = 3, // AVX-512 F + BW + VL (Skylake-X and later)
+	CPU_LEVEL_COUNT
+} cpu_level;
+
+
+// highest level this CPU and OS support
+cpu_level cpu_detect(void);
+
+// level kernels should use: cpu_detect(), lowered by CPU_LEVEL if it is set
+cpu_level cpu_active_level(void);
+
+const char* cpu_level_name(cpu_level level);
+
+
+#ifdef __cplusplus
+}
+#endif
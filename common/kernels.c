@@ -0,0 +1,299 @@
+/**
+ * Runtime dispatch tables for the course kernels
+ * Uses C99 dialect, so compile with -std=gnu99 or -std=c99
+ */
+#include "kernels_impl.h"
+#include "atomics.h" // atomic_store_ptr, atomic_store_int, atomic_load_int
+#include <stdio.h>   // printf, fprintf
+#include <string.h>  // memcpy, memcmp, memset, strlen
+
+#if _WIN32
+	#define WIN32_LEAN_AND_MEAN
+	#include <Windows.h> // InitOnceExecuteOnce
+#else
+	#include <pthread.h> // pthread_once
+#endif
+
+
+static const kernel_table tables[CPU_LEVEL_COUNT] = {
+	{ CPU_SCALAR, xor_bytes_scalar, hex_encode_scalar, hash_u32_scalar,
+	  minmax_i32_scalar, histogram_i32_scalar, str_nlen_scalar, str_copy_scalar, xoshiro8_u64_scalar },
+#if CPU_X86
+	{ CPU_SSE2, xor_bytes_sse2, hex_encode_sse2, hash_u32_sse2,
+	  minmax_i32_sse2, histogram_i32_x4, str_nlen_sse2, str_copy_sse2, xoshiro8_u64_sse2 },
+	{ CPU_AVX2, xor_bytes_avx2, hex_encode_avx2, hash_u32_avx2,
+	  minmax_i32_avx2, histogram_i32_x4, str_nlen_avx2, str_copy_avx2, xoshiro8_u64_avx2 },
+	// strings are mostly short, 64-byte blocks don't pay off over AVX2
+	{ CPU_AVX512, xor_bytes_avx512, hex_encode_avx512, hash_u32_avx512,
+	  minmax_i32_avx512, histogram_i32_x4, str_nlen_avx2, str_copy_avx2, xoshiro8_u64_avx512 },
+#endif
+};
+
+
+const kernel_table* kernels_for_level(cpu_level level)
+{
+	if (level < CPU_SCALAR || level > cpu_detect())
+		return NULL;
+	return &tables[level];
+}
+
+
+// other threads may be calling through the table while it's filled, so every entry
+// is stored atomically: a reader sees either the stub or the final variant
+#define INSTALL(entry) atomic_store_ptr((void* volatile*)&kernels.entry, (void*)t->entry)
+
+static void install_table(void)
+{
+	const kernel_table* t = kernels_for_level(cpu_active_level());
+	INSTALL(xor_bytes);
+	INSTALL(hex_encode);
+	INSTALL(hash_u32);
+	INSTALL(minmax_i32);
+	INSTALL(histogram_i32);
+	INSTALL(str_nlen);
+	INSTALL(str_copy);
+	INSTALL(xoshiro8_u64);
+	atomic_store_int((volatile int*)&kernels.level, t->level);
+}
+
+#if _WIN32
+static INIT_ONCE initOnce = INIT_ONCE_STATIC_INIT;
+static BOOL CALLBACK install_once(PINIT_ONCE once, PVOID param, PVOID* context)
+{
+	install_table();
+	return TRUE;
+}
+#else
+static pthread_once_t initOnce = PTHREAD_ONCE_INIT;
+#endif
+
+
+cpu_level kernels_init(void)
+{
+	// runs install_table() exactly once; concurrent callers wait until it's done
+#if _WIN32
+	InitOnceExecuteOnce(&initOnce, install_once, NULL, NULL);
+#else
+	pthread_once(&initOnce, install_table);
+#endif
+	return (cpu_level)atomic_load_int((volatile int*)&kernels.level);
+}
+
+
+
+
+
+/**
+ * Until kernels_init() runs, the table points at these stubs: the first call through
+ * any entry fills the whole table and forwards to the real variant
+ */
+static void resolve_xor_bytes(void* dst, const void* src, const void* key, size_t n)
+{
+	kernels_init();
+	kernels.xor_bytes(dst, src, key, n);
+}
+static void resolve_hex_encode(char* out, const void* in, size_t n)
+{
+	kernels_init();
+	kernels.hex_encode(out, in, n);
+}
+static void resolve_hash_u32(uint32_t* out, const uint32_t* in, size_t n)
+{
+	kernels_init();
+	kernels.hash_u32(out, in, n);
+}
+static void resolve_minmax_i32(const int* values, size_t n, int* min, int* max)
+{
+	kernels_init();
+	kernels.minmax_i32(values, n, min, max);
+}
+static void resolve_histogram_i32(int* counts, size_t bins, const int* values, size_t n, int min)
+{
+	kernels_init();
+	kernels.histogram_i32(counts, bins, values, n, min);
+}
+static size_t resolve_str_nlen(const char* s, size_t limit)
+{
+	kernels_init();
+	return kernels.str_nlen(s, limit);
+}
+static char* resolve_str_copy(char* dst, const char* src)
+{
+	kernels_init();
+	return kernels.str_copy(dst, src);
+}
+static void resolve_xoshiro8_u64(uint64_t state[32], uint64_t* out, size_t count)
+{
+	kernels_init();
+	kernels.xoshiro8_u64(state, out, count);
+}
+
+kernel_table kernels = {
+	CPU_SCALAR, resolve_xor_bytes, resolve_hex_encode, resolve_hash_u32,
+	resolve_minmax_i32, resolve_histogram_i32, resolve_str_nlen, resolve_str_copy,
+	resolve_xoshiro8_u64
+};
+
+
+
+
+
+
+/**
+ * Self test: every level against the scalar reference (and libc for strings)
+ */
+#define TEST_MAX 1100 // longer than any unrolled loop, so every main loop and tail runs
+
+static unsigned test_seed = 1;
+static unsigned test_random(void) // xorshift32, deterministic across runs
+{
+	test_seed ^= test_seed << 13;
+	test_seed ^= test_seed >> 17;
+	test_seed ^= test_seed << 5;
+	return test_seed;
+}
+
+
+static int test_failures;
+static void test_check(int ok, const kernel_table* t, const char* what, size_t n, size_t offset)
+{
+	if (!ok && ++test_failures <= 20)
+		fprintf(stderr, "kernels %s: %s failed (n=%zu offset=%zu)\n",
+		        cpu_level_name(t->level), what, n, offset);
+}
+
+
+static void test_buffers(const kernel_table* t, const kernel_table* ref, size_t n, size_t offset)
+{
+	static unsigned char src[TEST_MAX + 64], key[TEST_MAX + 64], got[2 * TEST_MAX + 64], expect[2 * TEST_MAX + 64];
+	static uint32_t words[TEST_MAX + 16], hashGot[TEST_MAX + 16], hashExpect[TEST_MAX + 16];
+	for (size_t i = 0; i < n + offset; ++i)
+	{
+		src[i] = (unsigned char)test_random();
+		key[i] = (unsigned char)test_random();
+	}
+
+	memset(got, '#', n + 1);
+	ref->xor_bytes(expect, src + offset, key, n);
+	t->xor_bytes(got, src + offset, key, n);
+	test_check(memcmp(got, expect, n) == 0 && got[n] == '#', t, "xor_bytes", n, offset);
+	memcpy(got, src + offset, n);
+	t->xor_bytes(got, got, key, n); // in place, like the cypher does
+	test_check(memcmp(got, expect, n) == 0, t, "xor_bytes in place", n, offset);
+
+	memset(got, '#', 2 * n + 1);
+	ref->hex_encode((char*)expect, src + offset, n);
+	t->hex_encode((char*)got, src + offset, n);
+	test_check(memcmp(got, expect, 2 * n) == 0 && got[2 * n] == '#', t, "hex_encode", n, offset);
+
+	for (size_t i = 0; i < n + offset; ++i)
+		words[i] = test_random();
+	hashGot[n] = 0xfeedf00du;
+	ref->hash_u32(hashExpect, words + offset, n);
+	t->hash_u32(hashGot, words + offset, n);
+	test_check(memcmp(hashGot, hashExpect, n * sizeof(uint32_t)) == 0 && hashGot[n] == 0xfeedf00du,
+	           t, "hash_u32", n, offset);
+
+	// the generators must produce the same sequence at every level, also across calls
+	if (n % 8 == 0 && n <= 256 && offset == 0)
+	{
+		static uint64_t state1[32], state2[32], rand1[2 * 256 + 8], rand2[2 * 256 + 8];
+		for (int i = 0; i < 32; ++i)
+			state1[i] = state2[i] = ((uint64_t)test_random() << 32) | test_random();
+		rand2[2 * n] = 0xfeedf00du;
+		ref->xoshiro8_u64(state1, rand1, n);
+		ref->xoshiro8_u64(state1, rand1 + n, n);
+		t->xoshiro8_u64(state2, rand2, n);
+		t->xoshiro8_u64(state2, rand2 + n, n);
+		test_check(memcmp(rand1, rand2, 2 * n * sizeof(uint64_t)) == 0 && rand2[2 * n] == 0xfeedf00du,
+		           t, "xoshiro8_u64", n, offset);
+	}
+}
+
+
+static void test_ints(const kernel_table* t, const kernel_table* ref, size_t n, size_t offset)
+{
+	static int values[TEST_MAX + 16], got[1024], expect[1024];
+	// a few bins force lanes of one vector into the same bin, many bins spread them out
+	static const int ranges[] = { 1, 3, 17, 1024 };
+	for (int r = 0; r < 4; ++r)
+	{
+		int base = (int)(test_random() % 2000) - 1000;
+		for (size_t i = 0; i < n + offset; ++i)
+			values[i] = base + (int)(test_random() % (unsigned)ranges[r]);
+
+		if (n > 0)
+		{
+			int min1, max1, min2, max2;
+			ref->minmax_i32(values + offset, n, &min1, &max1);
+			t->minmax_i32(values + offset, n, &min2, &max2);
+			test_check(min1 == min2 && max1 == max2, t, "minmax_i32", n, offset);
+		}
+
+		memset(got, 0, sizeof(int) * ranges[r]);
+		memset(expect, 0, sizeof(int) * ranges[r]);
+		ref->histogram_i32(expect, ranges[r], values + offset, n, base);
+		t->histogram_i32(got, ranges[r], values + offset, n, base);
+		test_check(memcmp(got, expect, sizeof(int) * ranges[r]) == 0, t, "histogram_i32", n, offset);
+	}
+
+	// full int range, minmax only
+	for (size_t i = 0; i < n + offset; ++i)
+		values[i] = (int)test_random();
+	if (n > 0)
+	{
+		int min1, max1, min2, max2;
+		ref->minmax_i32(values + offset, n, &min1, &max1);
+		t->minmax_i32(values + offset, n, &min2, &max2);
+		test_check(min1 == min2 && max1 == max2, t, "minmax_i32 full range", n, offset);
+	}
+}
+
+
+static void test_strings(const kernel_table* t)
+{
+	static char src[512 + 128], dst[512 + 128];
+	for (size_t len = 0; len <= 400; len += (len < 70 ? 1 : 37))
+	for (size_t align = 0; align < 64; ++align)
+	{
+		char* s = src + align;
+		memset(src, 'x', sizeof src); // no stray zeros after the terminator
+		for (size_t i = 0; i < len; ++i)
+			s[i] = (char)('a' + i % 26);
+		s[len] = 0;
+
+		test_check(t->str_nlen(s, (size_t)-1) == len, t, "str_nlen", len, align);
+		test_check(t->str_nlen(s, len / 2) == len / 2, t, "str_nlen limit", len, align);
+		test_check(t->str_nlen(s, len + 1) == len, t, "str_nlen limit past end", len, align);
+
+		char* d = dst + (align * 7) % 64; // unrelated src and dst alignments
+		memset(dst, '#', sizeof dst);
+		test_check(t->str_copy(d, s) == d && strcmp(d, s) == 0 && d[len + 1] == '#',
+		           t, "str_copy", len, align);
+	}
+}
+
+
+int kernels_selftest(int verbose)
+{
+	static const size_t offsets[] = { 0, 1, 7, 13 };
+	const kernel_table* ref = &tables[CPU_SCALAR];
+	test_failures = 0;
+
+	for (int level = CPU_SCALAR; level <= (int)cpu_detect(); ++level)
+	{
+		const kernel_table* t = kernels_for_level((cpu_level)level);
+		int before = test_failures;
+		for (size_t o = 0; o < 4; ++o)
+		for (size_t n = 0; n <= TEST_MAX; n += (n < 300 ? 1 : 97))
+		{
+			test_buffers(t, ref, n, offsets[o]);
+			test_ints(t, ref, n, offsets[o]);
+		}
+		test_strings(t);
+
+		if (verbose)
+			printf("kernels %-6s %s\n", cpu_level_name(t->level), test_failures == before ? "ok" : "FAILED");
+	}
+	return test_failures;
+}
@@ -0,0 +1,77 @@
+/**
+ * Hot loops of the course examples, dispatched at runtime to the best variant
+ * this CPU supports (scalar, SSE2, AVX2 or AVX-512)
+ *
+ * Call through the global table, e.g. kernels.xor_bytes(dst, src, key, n).
+ * The first call detects the CPU and fills the table, so no init call is needed.
+ * Set CPU_LEVEL=scalar|sse2|avx2|avx512 in the environment to force a lower level.
+ */
+#pragma once
+#include <stddef.h>       // size_t
+#include <stdint.h>       // uint32_t
+#include "cpu_features.h" // cpu_level
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+typedef struct _kernel_table {
+	cpu_level level; // instruction set these variants use
+
+	// dst[i] = src[i] ^ key[i], dst may be the same buffer as src
+	void (*xor_bytes)(void* dst, const void* src, const void* key, size_t n);
+
+	// writes 2*n lowercase hex digits of @in to @out, without a terminator
+	void (*hex_encode)(char* out, const void* in, size_t n);
+
+	// out[i] = hash32(in[i]), out may be the same buffer as in
+	void (*hash_u32)(uint32_t* out, const uint32_t* in, size_t n);
+
+	// smallest and largest of values[0..n), n must be > 0
+	void (*minmax_i32)(const int* values, size_t n, int* min, int* max);
+
+	// ++counts[values[i] - min] for every value; counts[0..bins) must cover [min, max]
+	void (*histogram_i32)(int* counts, size_t bins, const int* values, size_t n, int min);
+
+	// length of @s, but at most @limit; never reads an aligned block past the terminator
+	size_t (*str_nlen)(const char* s, size_t limit);
+
+	// copies @src including its terminator, returns dst
+	char* (*str_copy)(char* dst, const char* src);
+
+	// 8 interleaved xoshiro256** generators, out[i] comes from generator i % 8
+	// @state is s0[8], s1[8], s2[8], s3[8] and gets advanced; count must be a multiple of 8
+	void (*xoshiro8_u64)(uint64_t state[32], uint64_t* out, size_t count);
+} kernel_table;
+
+
+// the active table, filled once on first use with kernels_for_level(cpu_active_level())
+extern kernel_table kernels;
+
+// fills the table now instead of on first use, returns the level picked
+cpu_level kernels_init(void);
+
+// variants of a specific level, NULL if this CPU doesn't support it
+const kernel_table* kernels_for_level(cpu_level level);
+
+// runs every supported level against the scalar reference on random inputs
+// prints failures (and a per-level summary if @verbose), returns the failure count
+int kernels_selftest(int verbose);
+
+
+// murmur3 finalizer: a fast invertible mix of all 32 bits, reference for hash_u32
+static inline uint32_t hash32(uint32_t h)
+{
+	h ^= h >> 16;
+	h *= 0x85ebca6bu;
+	h ^= h >> 13;
+	h *= 0xc2b2ae35u;
+	h ^= h >> 16;
+	return h;
+}
+
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,228 @@
+/**
+ * AVX2 kernel variants: 32 bytes per step
+ * Uses C99 dialect, so compile with -std=gnu99 or -std=c99
+ */
+#include "kernels_impl.h"
+#if CPU_X86
+#include "bitops.h"  // bit_ctz32
+#include <string.h>  // memcpy
+
+
+void KERNEL_AVX2 xor_bytes_avx2(void* dst, const void* src, const void* key, size_t n)
+{
+	char* d = dst;
+	const char* s = src;
+	const char* k = key;
+	size_t i = 0;
+	for (; i + 128 <= n; i += 128)
+	{
+		for (int j = 0; j < 128; j += 32)
+		{
+			__m256i v = _mm256_xor_si256(_mm256_loadu_si256((const __m256i*)(s + i + j)),
+			                             _mm256_loadu_si256((const __m256i*)(k + i + j)));
+			_mm256_storeu_si256((__m256i*)(d + i + j), v);
+		}
+	}
+	for (; i + 32 <= n; i += 32)
+	{
+		__m256i v = _mm256_xor_si256(_mm256_loadu_si256((const __m256i*)(s + i)),
+		                             _mm256_loadu_si256((const __m256i*)(k + i)));
+		_mm256_storeu_si256((__m256i*)(d + i), v);
+	}
+	xor_bytes_scalar(d + i, s + i, k + i, n - i);
+}
+
+
+void KERNEL_AVX2 hex_encode_avx2(char* out, const void* in, size_t n)
+{
+	const char* p = in;
+	// pshufb looks up the digit of every nibble, separately in each 128-bit lane
+	const __m256i digits = _mm256_setr_epi8('0','1','2','3','4','5','6','7','8','9','a','b','c','d','e','f',
+	                                        '0','1','2','3','4','5','6','7','8','9','a','b','c','d','e','f');
+	const __m256i low4 = _mm256_set1_epi8(15);
+	size_t i = 0;
+	for (; i + 32 <= n; i += 32)
+	{
+		__m256i v  = _mm256_loadu_si256((const __m256i*)(p + i));
+		__m256i hi = _mm256_shuffle_epi8(digits, _mm256_and_si256(_mm256_srli_epi16(v, 4), low4));
+		__m256i lo = _mm256_shuffle_epi8(digits, _mm256_and_si256(v, low4));
+		// unpack works per lane: a = bytes 0-7 | 16-23, b = bytes 8-15 | 24-31
+		__m256i a = _mm256_unpacklo_epi8(hi, lo);
+		__m256i b = _mm256_unpackhi_epi8(hi, lo);
+		_mm256_storeu_si256((__m256i*)(out + i * 2),      _mm256_permute2x128_si256(a, b, 0x20));
+		_mm256_storeu_si256((__m256i*)(out + i * 2 + 32), _mm256_permute2x128_si256(a, b, 0x31));
+	}
+	hex_encode_scalar(out + i * 2, p + i, n - i);
+}
+
+
+void KERNEL_AVX2 hash_u32_avx2(uint32_t* out, const uint32_t* in, size_t n)
+{
+	const __m256i m1 = _mm256_set1_epi32((int)0x85ebca6bu);
+	const __m256i m2 = _mm256_set1_epi32((int)0xc2b2ae35u);
+	size_t i = 0;
+	for (; i + 8 <= n; i += 8)
+	{
+		__m256i h = _mm256_loadu_si256((const __m256i*)(in + i));
+		h = _mm256_xor_si256(h, _mm256_srli_epi32(h, 16));
+		h = _mm256_mullo_epi32(h, m1);
+		h = _mm256_xor_si256(h, _mm256_srli_epi32(h, 13));
+		h = _mm256_mullo_epi32(h, m2);
+		h = _mm256_xor_si256(h, _mm256_srli_epi32(h, 16));
+		_mm256_storeu_si256((__m256i*)(out + i), h);
+	}
+	hash_u32_scalar(out + i, in + i, n - i);
+}
+
+
+void KERNEL_AVX2 minmax_i32_avx2(const int* values, size_t n, int* min, int* max)
+{
+	__m256i vmin = _mm256_set1_epi32(values[0]);
+	__m256i vmax = vmin;
+	size_t i = 0;
+	for (; i + 8 <= n; i += 8)
+	{
+		__m256i v = _mm256_loadu_si256((const __m256i*)(values + i));
+		vmin = _mm256_min_epi32(vmin, v);
+		vmax = _mm256_max_epi32(vmax, v);
+	}
+	int lo[8], hi[8];
+	_mm256_storeu_si256((__m256i*)lo, vmin);
+	_mm256_storeu_si256((__m256i*)hi, vmax);
+	for (int k = 1; k < 8; ++k)
+	{
+		if (lo[k] < lo[0]) lo[0] = lo[k];
+		if (hi[k] > hi[0]) hi[0] = hi[k];
+	}
+	for (; i < n; ++i)
+	{
+		if (values[i] < lo[0]) lo[0] = values[i];
+		if (values[i] > hi[0]) hi[0] = values[i];
+	}
+	*min = lo[0];
+	*max = hi[0];
+}
+
+
+static inline KERNEL_AVX2 __m256i rotl_epi64_avx2(__m256i x, int k)
+{
+	return _mm256_or_si256(_mm256_slli_epi64(x, k), _mm256_srli_epi64(x, 64 - k));
+}
+
+
+void KERNEL_AVX2 xoshiro8_u64_avx2(uint64_t state[32], uint64_t* out, size_t count)
+{
+	for (int g = 0; g < 8; g += 4) // generators g..g+3, one pass over out each
+	{
+		__m256i s0 = _mm256_loadu_si256((const __m256i*)(state + g));
+		__m256i s1 = _mm256_loadu_si256((const __m256i*)(state + 8 + g));
+		__m256i s2 = _mm256_loadu_si256((const __m256i*)(state + 16 + g));
+		__m256i s3 = _mm256_loadu_si256((const __m256i*)(state + 24 + g));
+		for (size_t i = g; i < count; i += 8)
+		{
+			__m256i x5 = _mm256_add_epi64(s1, _mm256_slli_epi64(s1, 2));
+			__m256i r  = rotl_epi64_avx2(x5, 7);
+			_mm256_storeu_si256((__m256i*)(out + i), _mm256_add_epi64(r, _mm256_slli_epi64(r, 3)));
+			__m256i t = _mm256_slli_epi64(s1, 17);
+			s2 = _mm256_xor_si256(s2, s0);
+			s3 = _mm256_xor_si256(s3, s1);
+			s1 = _mm256_xor_si256(s1, s2);
+			s0 = _mm256_xor_si256(s0, s3);
+			s2 = _mm256_xor_si256(s2, t);
+			s3 = rotl_epi64_avx2(s3, 45);
+		}
+		_mm256_storeu_si256((__m256i*)(state + g), s0);
+		_mm256_storeu_si256((__m256i*)(state + 8 + g), s1);
+		_mm256_storeu_si256((__m256i*)(state + 16 + g), s2);
+		_mm256_storeu_si256((__m256i*)(state + 24 + g), s3);
+	}
+}
+
+
+
+
+
+/**
+ * Strings: only aligned 32-byte loads, which never cross a page
+ */
+
+// bit i is set if byte i of the aligned 32-byte block at @p is zero
+static inline KERNEL_AVX2 uint32_t zero_mask32(const char* p)
+{
+	__m256i block = _mm256_load_si256((const __m256i*)p);
+	return (uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(block, _mm256_setzero_si256()));
+}
+
+
+size_t KERNEL_AVX2 str_nlen_avx2(const char* s, size_t limit)
+{
+	size_t misalign = (uintptr_t)s & 31;
+	const char* p = s - misalign;
+	uint32_t mask = zero_mask32(p) >> misalign; // drop the bytes before s
+	if (mask)
+	{
+		size_t n = bit_ctz32(mask);
+		return n < limit ? n : limit;
+	}
+
+	// single blocks until p is 128-byte aligned, then 4 blocks per step
+	for (p += 32; (size_t)(p - s) < limit; p += 32)
+	{
+		if (((uintptr_t)p & 127) == 0)
+		{
+			const __m256i zero = _mm256_setzero_si256();
+			for (; (size_t)(p - s) < limit; p += 128)
+			{
+				__m256i a = _mm256_load_si256((const __m256i*)p);
+				__m256i b = _mm256_load_si256((const __m256i*)(p + 32));
+				__m256i c = _mm256_load_si256((const __m256i*)(p + 64));
+				__m256i d = _mm256_load_si256((const __m256i*)(p + 96));
+				__m256i min = _mm256_min_epu8(_mm256_min_epu8(a, b), _mm256_min_epu8(c, d));
+				if (_mm256_movemask_epi8(_mm256_cmpeq_epi8(min, zero)))
+					break;
+			}
+			if ((size_t)(p - s) >= limit)
+				return limit;
+		}
+		mask = zero_mask32(p);
+		if (mask)
+		{
+			size_t n = (size_t)(p - s) + bit_ctz32(mask);
+			return n < limit ? n : limit;
+		}
+	}
+	return limit;
+}
+
+
+char* KERNEL_AVX2 str_copy_avx2(char* dst, const char* src)
+{
+	const __m256i zero = _mm256_setzero_si256();
+	size_t misalign = (uintptr_t)src & 31;
+	const char* p = src - misalign;
+
+	uint32_t mask = zero_mask32(p) >> misalign;
+	if (mask) // short string, ends in the first block
+	{
+		memcpy(dst, src, bit_ctz32(mask) + 1);
+		return dst;
+	}
+
+	size_t head = 32 - misalign;
+	memcpy(dst, src, head);
+	char* d = dst + head;
+
+	for (p += 32;; p += 32, d += 32)
+	{
+		__m256i block = _mm256_load_si256((const __m256i*)p);
+		mask = (uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(block, zero));
+		if (mask)
+		{
+			memcpy(d, p, bit_ctz32(mask) + 1);
+			return dst;
+		}
+		_mm256_storeu_si256((__m256i*)d, block);
+	}
+}
+
+#endif // CPU_X86
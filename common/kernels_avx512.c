@@ -0,0 +1,122 @@
+/**
+ * AVX-512 kernel variants: 64 bytes per step, masked loads/stores for the tails
+ * Uses C99 dialect, so compile with -std=gnu99 or -std=c99
+ */
+#include "kernels_impl.h"
+#if CPU_X86
+
+
+// mask of the lowest @count lanes, count <= 64
+static inline KERNEL_AVX512 __mmask64 tail_mask64(size_t count)
+{
+	return count >= 64 ? ~(__mmask64)0 : (((__mmask64)1 << count) - 1);
+}
+
+
+void KERNEL_AVX512 xor_bytes_avx512(void* dst, const void* src, const void* key, size_t n)
+{
+	char* d = dst;
+	const char* s = src;
+	const char* k = key;
+	size_t i = 0;
+	for (; i + 256 <= n; i += 256)
+	{
+		for (int j = 0; j < 256; j += 64)
+		{
+			__m512i v = _mm512_xor_si512(_mm512_loadu_si512(s + i + j), _mm512_loadu_si512(k + i + j));
+			_mm512_storeu_si512(d + i + j, v);
+		}
+	}
+	for (; i < n; i += 64) // masked lanes are neither read nor written
+	{
+		__mmask64 m = tail_mask64(n - i);
+		__m512i v = _mm512_xor_si512(_mm512_maskz_loadu_epi8(m, s + i), _mm512_maskz_loadu_epi8(m, k + i));
+		_mm512_mask_storeu_epi8(d + i, m, v);
+	}
+}
+
+
+void KERNEL_AVX512 hex_encode_avx512(char* out, const void* in, size_t n)
+{
+	const char* p = in;
+	const __m512i digits = _mm512_broadcast_i32x4(_mm_setr_epi8('0','1','2','3','4','5','6','7',
+	                                                            '8','9','a','b','c','d','e','f'));
+	const __m512i low4 = _mm512_set1_epi8(15);
+	// unpack works per 128-bit lane, these put the 8-byte halves back in order
+	const __m512i first  = _mm512_setr_epi64(0, 1, 8, 9, 2, 3, 10, 11);
+	const __m512i second = _mm512_setr_epi64(4, 5, 12, 13, 6, 7, 14, 15);
+	size_t i = 0;
+	for (; i + 64 <= n; i += 64)
+	{
+		__m512i v  = _mm512_loadu_si512(p + i);
+		__m512i hi = _mm512_shuffle_epi8(digits, _mm512_and_si512(_mm512_srli_epi16(v, 4), low4));
+		__m512i lo = _mm512_shuffle_epi8(digits, _mm512_and_si512(v, low4));
+		__m512i a = _mm512_unpacklo_epi8(hi, lo);
+		__m512i b = _mm512_unpackhi_epi8(hi, lo);
+		_mm512_storeu_si512(out + i * 2,      _mm512_permutex2var_epi64(a, first, b));
+		_mm512_storeu_si512(out + i * 2 + 64, _mm512_permutex2var_epi64(a, second, b));
+	}
+	hex_encode_avx2(out + i * 2, p + i, n - i);
+}
+
+
+void KERNEL_AVX512 hash_u32_avx512(uint32_t* out, const uint32_t* in, size_t n)
+{
+	const __m512i m1 = _mm512_set1_epi32((int)0x85ebca6bu);
+	const __m512i m2 = _mm512_set1_epi32((int)0xc2b2ae35u);
+	for (size_t i = 0; i < n; i += 16)
+	{
+		__mmask16 m = (__mmask16)tail_mask64(n - i < 16 ? n - i : 16);
+		__m512i h = _mm512_maskz_loadu_epi32(m, in + i);
+		h = _mm512_xor_si512(h, _mm512_srli_epi32(h, 16));
+		h = _mm512_mullo_epi32(h, m1);
+		h = _mm512_xor_si512(h, _mm512_srli_epi32(h, 13));
+		h = _mm512_mullo_epi32(h, m2);
+		h = _mm512_xor_si512(h, _mm512_srli_epi32(h, 16));
+		_mm512_mask_storeu_epi32(out + i, m, h);
+	}
+}
+
+
+void KERNEL_AVX512 minmax_i32_avx512(const int* values, size_t n, int* min, int* max)
+{
+	__m512i vmin = _mm512_set1_epi32(values[0]);
+	__m512i vmax = vmin;
+	for (size_t i = 0; i < n; i += 16)
+	{
+		// lanes past the end keep values[0], which is already part of the result
+		__mmask16 m = (__mmask16)tail_mask64(n - i < 16 ? n - i : 16);
+		__m512i v = _mm512_mask_loadu_epi32(vmin, m, values + i);
+		vmin = _mm512_min_epi32(vmin, v);
+		vmax = _mm512_max_epi32(vmax, _mm512_mask_loadu_epi32(vmax, m, values + i));
+	}
+	*min = _mm512_reduce_min_epi32(vmin);
+	*max = _mm512_reduce_max_epi32(vmax);
+}
+
+// all 8 generators in one register each, with a native 64-bit rotate
+void KERNEL_AVX512 xoshiro8_u64_avx512(uint64_t state[32], uint64_t* out, size_t count)
+{
+	__m512i s0 = _mm512_loadu_si512(state);
+	__m512i s1 = _mm512_loadu_si512(state + 8);
+	__m512i s2 = _mm512_loadu_si512(state + 16);
+	__m512i s3 = _mm512_loadu_si512(state + 24);
+	for (size_t i = 0; i < count; i += 8)
+	{
+		__m512i r = _mm512_rol_epi64(_mm512_add_epi64(s1, _mm512_slli_epi64(s1, 2)), 7);
+		_mm512_storeu_si512(out + i, _mm512_add_epi64(r, _mm512_slli_epi64(r, 3)));
+		__m512i t = _mm512_slli_epi64(s1, 17);
+		s2 = _mm512_xor_si512(s2, s0);
+		s3 = _mm512_xor_si512(s3, s1);
+		s1 = _mm512_xor_si512(s1, s2);
+		s0 = _mm512_xor_si512(s0, s3);
+		s2 = _mm512_xor_si512(s2, t);
+		s3 = _mm512_rol_epi64(s3, 45);
+	}
+	_mm512_storeu_si512(state, s0);
+	_mm512_storeu_si512(state + 8, s1);
+	_mm512_storeu_si512(state + 16, s2);
+	_mm512_storeu_si512(state + 24, s3);
+}
+
+#endif // CPU_X86
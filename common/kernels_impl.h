@@ -0,0 +1,59 @@
+/**
+ * Per-level kernel variants behind kernels.h, only included by the kernels_*.c files
+ *
+ * Every variant file is compiled with the same flags as the rest of the program;
+ * functions using AVX2/AVX-512 are marked with KERNEL_AVX2/KERNEL_AVX512 so GCC and
+ * Clang emit those instructions only there. MSVC allows any intrinsic anywhere.
+ * Variants only get called after cpu_detect() said the CPU supports them.
+ */
+#pragma once
+#include "kernels.h"
+
+#if CPU_X86
+	#include <immintrin.h> // SSE2, AVX2, AVX-512
+#endif
+
+#if CPU_X86 && (__GNUC__ || __clang__)
+	#define KERNEL_SSE2   __attribute__((target("sse2")))
+	#define KERNEL_AVX2   __attribute__((target("avx2")))
+	#define KERNEL_AVX512 __attribute__((target("avx2,avx512f,avx512bw,avx512vl")))
+#else
+	#define KERNEL_SSE2
+	#define KERNEL_AVX2
+	#define KERNEL_AVX512
+#endif
+
+
+void   xor_bytes_scalar(void* dst, const void* src, const void* key, size_t n);
+void   hex_encode_scalar(char* out, const void* in, size_t n);
+void   hash_u32_scalar(uint32_t* out, const uint32_t* in, size_t n);
+void   minmax_i32_scalar(const int* values, size_t n, int* min, int* max);
+void   histogram_i32_scalar(int* counts, size_t bins, const int* values, size_t n, int min);
+void   histogram_i32_x4(int* counts, size_t bins, const int* values, size_t n, int min); // SSE2 and up
+size_t str_nlen_scalar(const char* s, size_t limit); // word at a time
+char*  str_copy_scalar(char* dst, const char* src);
+void   xoshiro8_u64_scalar(uint64_t state[32], uint64_t* out, size_t count);
+
+#if CPU_X86
+void   xor_bytes_sse2(void* dst, const void* src, const void* key, size_t n);
+void   hex_encode_sse2(char* out, const void* in, size_t n);
+void   hash_u32_sse2(uint32_t* out, const uint32_t* in, size_t n);
+void   minmax_i32_sse2(const int* values, size_t n, int* min, int* max);
+size_t str_nlen_sse2(const char* s, size_t limit);
+char*  str_copy_sse2(char* dst, const char* src);
+void   xoshiro8_u64_sse2(uint64_t state[32], uint64_t* out, size_t count);
+
+void   xor_bytes_avx2(void* dst, const void* src, const void* key, size_t n);
+void   hex_encode_avx2(char* out, const void* in, size_t n);
+void   hash_u32_avx2(uint32_t* out, const uint32_t* in, size_t n);
+void   minmax_i32_avx2(const int* values, size_t n, int* min, int* max);
+size_t str_nlen_avx2(const char* s, size_t limit);
+char*  str_copy_avx2(char* dst, const char* src);
+void   xoshiro8_u64_avx2(uint64_t state[32], uint64_t* out, size_t count);
+
+void   xor_bytes_avx512(void* dst, const void* src, const void* key, size_t n);
+void   hex_encode_avx512(char* out, const void* in, size_t n);
+void   hash_u32_avx512(uint32_t* out, const uint32_t* in, size_t n);
+void   minmax_i32_avx512(const int* values, size_t n, int* min, int* max);
+void   xoshiro8_u64_avx512(uint64_t state[32], uint64_t* out, size_t count);
+#endif
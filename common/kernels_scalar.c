@@ -0,0 +1,200 @@
+/**
+ * Scalar kernel variants: the reference every SIMD level is tested against,
+ * and the fallback for CPUs without SSE2
+ * Uses C99 dialect, so compile with -std=gnu99 or -std=c99
+ */
+#include "kernels_impl.h"
+#include "bitops.h"  // bit_ctz64
+#include <string.h>  // memcpy, memset
+
+
+void xor_bytes_scalar(void* dst, const void* src, const void* key, size_t n)
+{
+	unsigned char* d = dst;
+	const unsigned char* s = src;
+	const unsigned char* k = key;
+	for (size_t i = 0; i < n; ++i)
+		d[i] = s[i] ^ k[i];
+}
+
+
+void hex_encode_scalar(char* out, const void* in, size_t n)
+{
+	static const char digits[] = "0123456789abcdef";
+	const unsigned char* p = in;
+	for (size_t i = 0; i < n; ++i)
+	{
+		out[i * 2 + 0] = digits[p[i] >> 4];
+		out[i * 2 + 1] = digits[p[i] & 15];
+	}
+}
+
+
+void hash_u32_scalar(uint32_t* out, const uint32_t* in, size_t n)
+{
+	for (size_t i = 0; i < n; ++i)
+		out[i] = hash32(in[i]);
+}
+
+
+void minmax_i32_scalar(const int* values, size_t n, int* min, int* max)
+{
+	int lo = values[0], hi = values[0];
+	for (size_t i = 1; i < n; ++i)
+	{
+		if (values[i] < lo) lo = values[i];
+		if (values[i] > hi) hi = values[i];
+	}
+	*min = lo;
+	*max = hi;
+}
+
+
+// the loads and stores are random, which is what limits every histogram: SSE2/AVX2
+// have no scatter, and an AVX-512 gather/scatter version with vpconflictd for
+// repeated bins was 2x slower, so the faster levels use histogram_i32_x4 below
+void histogram_i32_scalar(int* counts, size_t bins, const int* values, size_t n, int min)
+{
+	(void)bins;
+	for (size_t i = 0; i < n; ++i)
+		++counts[values[i] - min];
+}
+
+
+#define HISTOGRAM_X4_MAX_BINS 1024 // 4 copies of 1024 bins still fit in L1
+
+// consecutive values hitting the same bin wait on each other's store; four
+// sub-histograms, merged at the end, let four increments run at the same time.
+// 3x faster with a handful of bins, slower once the copies spill out of L1,
+// so larger histograms take the plain loop
+void histogram_i32_x4(int* counts, size_t bins, const int* values, size_t n, int min)
+{
+	if (bins > HISTOGRAM_X4_MAX_BINS || n < 4 * bins)
+	{
+		histogram_i32_scalar(counts, bins, values, n, min);
+		return;
+	}
+	int sub[3][HISTOGRAM_X4_MAX_BINS];
+	memset(sub, 0, sizeof(sub));
+	size_t i = 0;
+	for (; i + 4 <= n; i += 4)
+	{
+		++counts[values[i] - min];
+		++sub[0][values[i + 1] - min];
+		++sub[1][values[i + 2] - min];
+		++sub[2][values[i + 3] - min];
+	}
+	for (; i < n; ++i)
+		++counts[values[i] - min];
+	for (size_t b = 0; b < bins; ++b)
+		counts[b] += sub[0][b] + sub[1][b] + sub[2][b];
+}
+
+
+
+
+
+/**
+ * Strings, word-at-a-time: 8 bytes per step
+ */
+#if __GNUC__
+	typedef uint64_t __attribute__((__may_alias__)) word_t; // reads chars through a uint64_t*
+#else
+	typedef uint64_t word_t;
+#endif
+
+#define WORD_SIZE  8
+#define WORD_ONES  0x0101010101010101ull
+#define WORD_HIGHS 0x8080808080808080ull
+
+// the first string byte must be the lowest byte of a word, both for finding the
+// first zero with bit_ctz64() and for masking the bytes before an unaligned start
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ != __ORDER_LITTLE_ENDIAN__
+	#error "the word-at-a-time string kernels need a little-endian target"
+#endif
+
+
+// sets the high bit of every byte that may be zero; on little-endian targets the
+// lowest flagged byte is always a real zero (false positives only appear above it)
+static inline word_t zero_bytes(word_t v)
+{
+	return (v - WORD_ONES) & ~v & WORD_HIGHS;
+}
+
+
+size_t str_nlen_scalar(const char* s, size_t limit)
+{
+	// start from the aligned word containing s, so no load ever crosses a page
+	size_t misalign = (uintptr_t)s & (WORD_SIZE - 1);
+	const word_t* w = (const word_t*)(s - misalign);
+	word_t v = *w | (((word_t)1 << (misalign * 8)) - 1); // bytes before s are not zeros
+
+	for (;;)
+	{
+		word_t zeros = zero_bytes(v);
+		if (zeros)
+		{
+			size_t n = (size_t)((const char*)w - s) + bit_ctz64(zeros) / 8;
+			return n < limit ? n : limit;
+		}
+		if ((size_t)((const char*)(w + 1) - s) >= limit)
+			return limit;
+		v = *++w;
+	}
+}
+
+
+char* str_copy_scalar(char* dst, const char* src)
+{
+	char* d = dst;
+	while ((uintptr_t)src & (WORD_SIZE - 1)) // byte steps until src is aligned
+	{
+		if ((*d++ = *src++) == 0)
+			return dst;
+	}
+
+	const word_t* w = (const word_t*)src;
+	for (word_t v = *w; !zero_bytes(v); v = *++w)
+	{
+		memcpy(d, &v, WORD_SIZE); // dst alignment is unknown
+		d += WORD_SIZE;
+	}
+
+	src = (const char*)w; // the terminator is in this word
+	while ((*d++ = *src++))
+		;
+	return dst;
+}
+
+
+
+
+
+/**
+ * xoshiro256** (Blackman & Vigna), one generator at a time
+ */
+static inline uint64_t rotl64(uint64_t x, int k)
+{
+	return (x << k) | (x >> (64 - k));
+}
+
+
+void xoshiro8_u64_scalar(uint64_t state[32], uint64_t* out, size_t count)
+{
+	for (int g = 0; g < 8; ++g)
+	{
+		uint64_t s0 = state[g], s1 = state[8 + g], s2 = state[16 + g], s3 = state[24 + g];
+		for (size_t i = g; i < count; i += 8)
+		{
+			out[i] = rotl64(s1 * 5, 7) * 9;
+			uint64_t t = s1 << 17;
+			s2 ^= s0;
+			s3 ^= s1;
+			s1 ^= s2;
+			s0 ^= s3;
+			s2 ^= t;
+			s3 = rotl64(s3, 45);
+		}
+		state[g] = s0, state[8 + g] = s1, state[16 + g] = s2, state[24 + g] = s3;
+	}
+}
@@ -0,0 +1,251 @@
+/**
+ * SSE2 kernel variants: 16 bytes per step
+ * Uses C99 dialect, so compile with -std=gnu99 or -std=c99
+ */
+#include "kernels_impl.h"
+#if CPU_X86
+#include "bitops.h"  // bit_ctz32
+#include <string.h>  // memcpy
+
+
+void KERNEL_SSE2 xor_bytes_sse2(void* dst, const void* src, const void* key, size_t n)
+{
+	char* d = dst;
+	const char* s = src;
+	const char* k = key;
+	size_t i = 0;
+	for (; i + 64 <= n; i += 64)
+	{
+		for (int j = 0; j < 64; j += 16)
+		{
+			__m128i v = _mm_xor_si128(_mm_loadu_si128((const __m128i*)(s + i + j)),
+			                          _mm_loadu_si128((const __m128i*)(k + i + j)));
+			_mm_storeu_si128((__m128i*)(d + i + j), v);
+		}
+	}
+	for (; i + 16 <= n; i += 16)
+	{
+		__m128i v = _mm_xor_si128(_mm_loadu_si128((const __m128i*)(s + i)),
+		                          _mm_loadu_si128((const __m128i*)(k + i)));
+		_mm_storeu_si128((__m128i*)(d + i), v);
+	}
+	xor_bytes_scalar(d + i, s + i, k + i, n - i);
+}
+
+
+// 16 nibbles (0..15) to their lowercase hex digits
+static inline KERNEL_SSE2 __m128i hex_digits_sse2(__m128i nibbles)
+{
+	// '0' + n, plus 'a' - '0' - 10 for n > 9
+	__m128i letters = _mm_and_si128(_mm_cmpgt_epi8(nibbles, _mm_set1_epi8(9)), _mm_set1_epi8('a' - '0' - 10));
+	return _mm_add_epi8(_mm_add_epi8(nibbles, _mm_set1_epi8('0')), letters);
+}
+
+
+void KERNEL_SSE2 hex_encode_sse2(char* out, const void* in, size_t n)
+{
+	const char* p = in;
+	const __m128i low4 = _mm_set1_epi8(15);
+	size_t i = 0;
+	for (; i + 16 <= n; i += 16)
+	{
+		__m128i v  = _mm_loadu_si128((const __m128i*)(p + i));
+		__m128i hi = hex_digits_sse2(_mm_and_si128(_mm_srli_epi16(v, 4), low4));
+		__m128i lo = hex_digits_sse2(_mm_and_si128(v, low4));
+		// interleave: the high nibble of each byte comes first
+		_mm_storeu_si128((__m128i*)(out + i * 2),      _mm_unpacklo_epi8(hi, lo));
+		_mm_storeu_si128((__m128i*)(out + i * 2 + 16), _mm_unpackhi_epi8(hi, lo));
+	}
+	hex_encode_scalar(out + i * 2, p + i, n - i);
+}
+
+
+// 32-bit lane multiply, SSE2 only has the 32x32->64 pmuludq on even lanes
+static inline KERNEL_SSE2 __m128i mullo_epi32_sse2(__m128i a, __m128i b)
+{
+	__m128i even = _mm_mul_epu32(a, b);
+	__m128i odd  = _mm_mul_epu32(_mm_srli_epi64(a, 32), _mm_srli_epi64(b, 32));
+	return _mm_unpacklo_epi32(_mm_shuffle_epi32(even, _MM_SHUFFLE(0, 0, 2, 0)),
+	                          _mm_shuffle_epi32(odd,  _MM_SHUFFLE(0, 0, 2, 0)));
+}
+
+
+void KERNEL_SSE2 hash_u32_sse2(uint32_t* out, const uint32_t* in, size_t n)
+{
+	const __m128i m1 = _mm_set1_epi32((int)0x85ebca6bu);
+	const __m128i m2 = _mm_set1_epi32((int)0xc2b2ae35u);
+	size_t i = 0;
+	for (; i + 4 <= n; i += 4)
+	{
+		__m128i h = _mm_loadu_si128((const __m128i*)(in + i));
+		h = _mm_xor_si128(h, _mm_srli_epi32(h, 16));
+		h = mullo_epi32_sse2(h, m1);
+		h = _mm_xor_si128(h, _mm_srli_epi32(h, 13));
+		h = mullo_epi32_sse2(h, m2);
+		h = _mm_xor_si128(h, _mm_srli_epi32(h, 16));
+		_mm_storeu_si128((__m128i*)(out + i), h);
+	}
+	hash_u32_scalar(out + i, in + i, n - i);
+}
+
+
+// mask ? a : b
+static inline KERNEL_SSE2 __m128i select_sse2(__m128i mask, __m128i a, __m128i b)
+{
+	return _mm_or_si128(_mm_and_si128(mask, a), _mm_andnot_si128(mask, b));
+}
+
+
+void KERNEL_SSE2 minmax_i32_sse2(const int* values, size_t n, int* min, int* max)
+{
+	__m128i vmin = _mm_set1_epi32(values[0]);
+	__m128i vmax = vmin;
+	size_t i = 0;
+	for (; i + 4 <= n; i += 4)
+	{
+		__m128i v = _mm_loadu_si128((const __m128i*)(values + i));
+		vmin = select_sse2(_mm_cmplt_epi32(v, vmin), v, vmin);
+		vmax = select_sse2(_mm_cmpgt_epi32(v, vmax), v, vmax);
+	}
+	int lo[4], hi[4];
+	_mm_storeu_si128((__m128i*)lo, vmin);
+	_mm_storeu_si128((__m128i*)hi, vmax);
+	for (int k = 1; k < 4; ++k)
+	{
+		if (lo[k] < lo[0]) lo[0] = lo[k];
+		if (hi[k] > hi[0]) hi[0] = hi[k];
+	}
+	for (; i < n; ++i)
+	{
+		if (values[i] < lo[0]) lo[0] = values[i];
+		if (values[i] > hi[0]) hi[0] = values[i];
+	}
+	*min = lo[0];
+	*max = hi[0];
+}
+
+
+static inline KERNEL_SSE2 __m128i rotl_epi64_sse2(__m128i x, int k)
+{
+	return _mm_or_si128(_mm_slli_epi64(x, k), _mm_srli_epi64(x, 64 - k));
+}
+
+
+// x * 5 and x * 9 are a shift and an add, so xoshiro256** needs no 64-bit multiply
+void KERNEL_SSE2 xoshiro8_u64_sse2(uint64_t state[32], uint64_t* out, size_t count)
+{
+	for (int g = 0; g < 8; g += 2) // generators g and g+1, one pass over out each
+	{
+		__m128i s0 = _mm_loadu_si128((const __m128i*)(state + g));
+		__m128i s1 = _mm_loadu_si128((const __m128i*)(state + 8 + g));
+		__m128i s2 = _mm_loadu_si128((const __m128i*)(state + 16 + g));
+		__m128i s3 = _mm_loadu_si128((const __m128i*)(state + 24 + g));
+		for (size_t i = g; i < count; i += 8)
+		{
+			__m128i x5 = _mm_add_epi64(s1, _mm_slli_epi64(s1, 2));
+			__m128i r  = rotl_epi64_sse2(x5, 7);
+			_mm_storeu_si128((__m128i*)(out + i), _mm_add_epi64(r, _mm_slli_epi64(r, 3)));
+			__m128i t = _mm_slli_epi64(s1, 17);
+			s2 = _mm_xor_si128(s2, s0);
+			s3 = _mm_xor_si128(s3, s1);
+			s1 = _mm_xor_si128(s1, s2);
+			s0 = _mm_xor_si128(s0, s3);
+			s2 = _mm_xor_si128(s2, t);
+			s3 = rotl_epi64_sse2(s3, 45);
+		}
+		_mm_storeu_si128((__m128i*)(state + g), s0);
+		_mm_storeu_si128((__m128i*)(state + 8 + g), s1);
+		_mm_storeu_si128((__m128i*)(state + 16 + g), s2);
+		_mm_storeu_si128((__m128i*)(state + 24 + g), s3);
+	}
+}
+
+
+
+
+
+/**
+ * Strings: only aligned 16-byte loads, which never cross a page
+ */
+
+// bit i is set if byte i of the aligned 16-byte block at @p is zero
+static inline KERNEL_SSE2 unsigned zero_mask16(const char* p)
+{
+	__m128i block = _mm_load_si128((const __m128i*)p);
+	return (unsigned)_mm_movemask_epi8(_mm_cmpeq_epi8(block, _mm_setzero_si128()));
+}
+
+
+size_t KERNEL_SSE2 str_nlen_sse2(const char* s, size_t limit)
+{
+	size_t misalign = (uintptr_t)s & 15;
+	const char* p = s - misalign;
+	unsigned mask = zero_mask16(p) >> misalign; // drop the bytes before s
+	if (mask)
+	{
+		size_t n = bit_ctz32(mask);
+		return n < limit ? n : limit;
+	}
+
+	// single blocks until p is 64-byte aligned, then 4 blocks per step;
+	// an aligned 64-byte chunk can't cross a page either
+	for (p += 16; (size_t)(p - s) < limit; p += 16)
+	{
+		if (((uintptr_t)p & 63) == 0)
+		{
+			const __m128i zero = _mm_setzero_si128();
+			for (; (size_t)(p - s) < limit; p += 64)
+			{
+				__m128i a = _mm_load_si128((const __m128i*)p);
+				__m128i b = _mm_load_si128((const __m128i*)(p + 16));
+				__m128i c = _mm_load_si128((const __m128i*)(p + 32));
+				__m128i d = _mm_load_si128((const __m128i*)(p + 48));
+				__m128i min = _mm_min_epu8(_mm_min_epu8(a, b), _mm_min_epu8(c, d)); // 0 if any byte is 0
+				if (_mm_movemask_epi8(_mm_cmpeq_epi8(min, zero)))
+					break; // the terminator is in this chunk, find it block by block
+			}
+			if ((size_t)(p - s) >= limit)
+				return limit;
+		}
+		mask = zero_mask16(p);
+		if (mask)
+		{
+			size_t n = (size_t)(p - s) + bit_ctz32(mask);
+			return n < limit ? n : limit;
+		}
+	}
+	return limit;
+}
+
+
+char* KERNEL_SSE2 str_copy_sse2(char* dst, const char* src)
+{
+	const __m128i zero = _mm_setzero_si128();
+	size_t misalign = (uintptr_t)src & 15;
+	const char* p = src - misalign;
+
+	unsigned mask = zero_mask16(p) >> misalign;
+	if (mask) // short string, ends in the first block
+	{
+		memcpy(dst, src, bit_ctz32(mask) + 1);
+		return dst;
+	}
+
+	size_t head = 16 - misalign; // rest of the first block, already known to be zero-free
+	memcpy(dst, src, head);
+	char* d = dst + head;
+
+	for (p += 16;; p += 16, d += 16)
+	{
+		__m128i block = _mm_load_si128((const __m128i*)p);
+		mask = (unsigned)_mm_movemask_epi8(_mm_cmpeq_epi8(block, zero));
+		if (mask)
+		{
+			memcpy(d, p, bit_ctz32(mask) + 1); // tail including the terminator
+			return dst;
+		}
+		_mm_storeu_si128((__m128i*)d, block);
+	}
+}
+
+#endif // CPU_X86
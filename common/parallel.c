@@ -0,0 +1,106 @@
+/**
+ * Minimal portable fork-join helper shared by the course examples
+ */
+#include "parallel.h"
+#include <stdlib.h> // malloc, free
+
+#if _WIN32
+	#define WIN32_LEAN_AND_MEAN
+	#include <Windows.h>
+#else
+	#include <pthread.h>
+	#include <unistd.h> // sysconf
+#endif
+
+
+typedef struct _parallel_job {
+	parallel_task task;
+	void* arg;
+	int   threadIdx;
+	int   numThreads;
+} parallel_job;
+
+
+int parallel_hw_threads(void)
+{
+#if _WIN32
+	SYSTEM_INFO info;
+	GetSystemInfo(&info);
+	return info.dwNumberOfProcessors > 0 ? (int)info.dwNumberOfProcessors : 1;
+#else
+	long n = sysconf(_SC_NPROCESSORS_ONLN);
+	return n > 0 ? (int)n : 1;
+#endif
+}
+
+
+#if _WIN32
+static DWORD WINAPI parallel_entry(LPVOID param)
+{
+	parallel_job* job = param;
+	job->task(job->arg, job->threadIdx, job->numThreads);
+	return 0;
+}
+#else
+static void* parallel_entry(void* param)
+{
+	parallel_job* job = param;
+	job->task(job->arg, job->threadIdx, job->numThreads);
+	return NULL;
+}
+#endif
+
+
+void parallel_run(int numThreads, parallel_task task, void* arg)
+{
+	if (numThreads <= 0)
+		numThreads = parallel_hw_threads();
+	if (numThreads == 1) {
+		task(arg, 0, 1);
+		return;
+	}
+
+	parallel_job* jobs = malloc(sizeof(parallel_job) * numThreads);
+#if _WIN32
+	HANDLE* threads = malloc(sizeof(HANDLE) * numThreads);
+#else
+	pthread_t* threads = malloc(sizeof(pthread_t) * numThreads);
+#endif
+	int* started = malloc(sizeof(int) * numThreads);
+
+	for (int i = 0; i < numThreads; ++i) {
+		jobs[i].task       = task;
+		jobs[i].arg        = arg;
+		jobs[i].threadIdx  = i;
+		jobs[i].numThreads = numThreads;
+	}
+
+	// spawn workers 1..N-1, if spawning fails the job is run inline instead
+	for (int i = 1; i < numThreads; ++i) {
+	#if _WIN32
+		threads[i] = CreateThread(NULL, 0, parallel_entry, &jobs[i], 0, NULL);
+		started[i] = threads[i] != NULL;
+	#else
+		started[i] = pthread_create(&threads[i], NULL, parallel_entry, &jobs[i]) == 0;
+	#endif
+		if (!started[i])
+			task(arg, i, numThreads);
+	}
+
+	task(arg, 0, numThreads); // the calling thread does its share too
+
+	for (int i = 1; i < numThreads; ++i) {
+		if (!started[i])
+			continue;
+	#if _WIN32
+		WaitForSingleObject(threads[i], INFINITE);
+		CloseHandle(threads[i]);
+	#else
+		pthread_join(threads[i], NULL);
+	#endif
+	}
+
+	free(started);
+	free(threads);
+	free(jobs);
+}
@@ -0,0 +1,41 @@
+/**
+ * Minimal portable fork-join helper shared by the course examples
+ * Uses pthreads on POSIX and the Win32 thread API on Windows
+ */
+#pragma once
+#include <stddef.h> // size_t
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+// a task run by parallel_run(); @threadIdx is in range [0, numThreads)
+typedef void (*parallel_task)(void* arg, int threadIdx, int numThreads);
+
+
+// number of hardware threads available to this process (at least 1)
+int parallel_hw_threads(void);
+
+
+// runs @task on @numThreads threads and waits until all of them have finished
+// the calling thread executes threadIdx 0, so numThreads=1 never spawns anything
+// if numThreads <= 0, parallel_hw_threads() is used
+void parallel_run(int numThreads, parallel_task task, void* arg);
+
+
+// splits [0, count) into @numThreads near-equal chunks and gives chunk @threadIdx
+static inline void parallel_chunk(size_t count, int threadIdx, int numThreads,
+                                  size_t* begin, size_t* end)
+{
+	size_t step = count / numThreads;
+	size_t rem  = count % numThreads;
+	size_t idx  = (size_t)threadIdx;
+	*begin = idx * step + (idx < rem ? idx : rem);
+	*end   = *begin + step + (idx < rem ? 1 : 0);
+}
+
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,261 @@
+/**
+ * Fast random numbers for generating test data
+ * Uses C99 dialect, so compile with -std=gnu99 or -std=c99
+ */
+#include "rng.h"
+#include "kernels.h"  // kernels.xoshiro8_u64
+#include "parallel.h" // parallel_run, parallel_chunk, parallel_hw_threads
+#include "trace.h"    // trace_zone_begin, trace_zone_end
+#include <math.h>     // log, exp, log1p, expm1, fabs
+#include <string.h>   // memcpy
+
+
+void rng_seed(rng_xoshiro* r, uint64_t seed)
+{
+	// SplitMix64 outputs are distinct, so the state can't be all zeros
+	for (int i = 0; i < 4; ++i)
+		r->s[i] = rng_at(seed, i);
+}
+
+
+void rng_jump(rng_xoshiro* r)
+{
+	static const uint64_t jump[4] = {
+		0x180ec6d33cfd0abaull, 0xd5a61266f0c9392cull, 0xa9582618e03fc9aaull, 0x39abdc4529b1661cull
+	};
+	uint64_t s[4] = { 0, 0, 0, 0 };
+	for (int i = 0; i < 4; ++i)
+	for (int b = 0; b < 64; ++b)
+	{
+		if (jump[i] & (1ull << b))
+		{
+			s[0] ^= r->s[0];
+			s[1] ^= r->s[1];
+			s[2] ^= r->s[2];
+			s[3] ^= r->s[3];
+		}
+		rng_next(r);
+	}
+	memcpy(r->s, s, sizeof s);
+}
+
+
+
+
+
+
+/**
+ * Zipf, rejection-inversion: invert the integral of the hat function 1/x^s, round
+ * to the nearest rank and accept if the sample falls under that rank's bar
+ */
+static double helper1(double x) // log(1 + x) / x, accurate near 0
+{
+	return fabs(x) > 1e-8 ? log1p(x) / x : 1.0 - x * (0.5 - x * (1.0 / 3.0 - 0.25 * x));
+}
+static double helper2(double x) // (exp(x) - 1) / x, accurate near 0
+{
+	return fabs(x) > 1e-8 ? expm1(x) / x : 1.0 + x * 0.5 * (1.0 + x * (1.0 / 3.0) * (1.0 + 0.25 * x));
+}
+static double hat(double x, double s)
+{
+	return exp(-s * log(x));
+}
+static double hat_integral(double x, double s)
+{
+	double logX = log(x);
+	return helper2((1.0 - s) * logX) * logX;
+}
+static double hat_integral_inverse(double x, double s)
+{
+	double t = x * (1.0 - s);
+	if (t < -1.0)
+		t = -1.0; // rounding can push it just past the pole
+	return exp(helper1(t) * x);
+}
+
+
+void rng_zipf_init(rng_zipf* z, int n, double s)
+{
+	z->n = n;
+	z->s = s;
+	z->hIntegralX1 = hat_integral(1.5, s) - 1.0;
+	z->hIntegralN  = hat_integral(n + 0.5, s);
+	z->cutoff = 2.0 - hat_integral_inverse(hat_integral(2.5, s) - hat(2.0, s), s);
+}
+
+
+int rng_zipf_next(const rng_zipf* z, rng_xoshiro* r)
+{
+	for (;;)
+	{
+		double u = z->hIntegralN + rng_unit(rng_next(r)) * (z->hIntegralX1 - z->hIntegralN);
+		double x = hat_integral_inverse(u, z->s);
+		int k = (int)(x + 0.5); // ranks start at 1 here
+		if (k < 1)         k = 1;
+		else if (k > z->n) k = z->n;
+		if (k - x <= z->cutoff || u >= hat_integral(k + 0.5, z->s) - hat(k, z->s))
+			return k - 1;
+	}
+}
+
+
+
+
+
+
+/**
+ * Bulk fills
+ * Block b of the output always comes from 8 xoshiro256** generators seeded with
+ * rng_at(seed, 32b .. 32b+31), so it doesn't matter which thread produces it
+ */
+#define RNG_BLOCK 2048 // 64-bit values per block, 16KB stays in L1
+
+enum fill_kind { FILL_BYTES, FILL_RANGE_I32, FILL_RANGE_I64, FILL_ZIPF_I32 };
+
+typedef struct _fill_job {
+	enum fill_kind kind;
+	void*    out;
+	size_t   count;  // bytes for FILL_BYTES, values otherwise
+	uint64_t seed;
+	int64_t  min;    // range fills
+	uint64_t range;  // max - min + 1, 0 means all 2^64 values
+	rng_zipf zipf;
+} fill_job;
+
+
+static void block_randoms(uint64_t seed, size_t block, uint64_t* out)
+{
+	uint64_t state[32];
+	for (int i = 0; i < 32; ++i)
+		state[i] = rng_at(seed, (uint64_t)block * 32 + i);
+	kernels.xoshiro8_u64(state, out, RNG_BLOCK);
+}
+
+
+static void fill_block(const fill_job* job, size_t block, uint64_t* words)
+{
+	switch (job->kind)
+	{
+		case FILL_BYTES:
+		{
+			size_t begin = block * RNG_BLOCK * sizeof(uint64_t);
+			size_t size  = job->count - begin;
+			char* dst = (char*)job->out + begin;
+			if (size >= RNG_BLOCK * sizeof(uint64_t) && ((uintptr_t)dst & 7) == 0)
+			{
+				block_randoms(job->seed, block, (uint64_t*)dst); // straight into the output
+				return;
+			}
+			block_randoms(job->seed, block, words);
+			memcpy(dst, words, size < RNG_BLOCK * sizeof(uint64_t) ? size : RNG_BLOCK * sizeof(uint64_t));
+			return;
+		}
+		case FILL_RANGE_I32:
+		case FILL_RANGE_I64:
+		{
+			size_t begin = block * RNG_BLOCK;
+			size_t n = job->count - begin < RNG_BLOCK ? job->count - begin : RNG_BLOCK;
+			block_randoms(job->seed, block, words);
+			if (job->kind == FILL_RANGE_I32)
+			{
+				int* dst = (int*)job->out + begin;
+				for (size_t i = 0; i < n; ++i)
+					dst[i] = (int)(job->min + (int64_t)rng_bounded(words[i], job->range));
+			}
+			else
+			{
+				int64_t* dst = (int64_t*)job->out + begin;
+				for (size_t i = 0; i < n; ++i)
+					dst[i] = (int64_t)((uint64_t)job->min + (job->range ? rng_bounded(words[i], job->range) : words[i]));
+			}
+			return;
+		}
+		case FILL_ZIPF_I32:
+		{
+			// rejection uses a varying number of randoms per value, so one generator per block
+			size_t begin = block * RNG_BLOCK;
+			size_t n = job->count - begin < RNG_BLOCK ? job->count - begin : RNG_BLOCK;
+			rng_xoshiro r;
+			rng_seed(&r, rng_at(job->seed, block));
+			int* dst = (int*)job->out + begin;
+			for (size_t i = 0; i < n; ++i)
+				dst[i] = rng_zipf_next(&job->zipf, &r);
+			return;
+		}
+	}
+}
+
+
+static size_t fill_blocks(const fill_job* job)
+{
+	size_t perBlock = job->kind == FILL_BYTES ? RNG_BLOCK * sizeof(uint64_t) : RNG_BLOCK;
+	return (job->count + perBlock - 1) / perBlock;
+}
+
+
+static void fill_task(void* arg, int threadIdx, int numThreads)
+{
+	const fill_job* job = arg;
+	uint64_t words[RNG_BLOCK];
+	size_t begin, end;
+	parallel_chunk(fill_blocks(job), threadIdx, numThreads, &begin, &end);
+	trace_zone zone = trace_zone_begin("rng_fill");
+	for (size_t b = begin; b < end; ++b)
+		fill_block(job, b, words);
+	trace_zone_end(zone);
+}
+
+
+static void fill_run(fill_job* job, int numThreads)
+{
+	size_t blocks = fill_blocks(job);
+	if (numThreads <= 0)
+		numThreads = parallel_hw_threads();
+	if ((size_t)numThreads > blocks) // small fills aren't worth a thread each
+		numThreads = blocks ? (int)blocks : 1;
+	parallel_run(numThreads, fill_task, job);
+}
+
+
+void rng_fill_bytes(void* out, size_t size, uint64_t seed, int numThreads)
+{
+	fill_job job = { FILL_BYTES, out, size, seed };
+	fill_run(&job, numThreads);
+}
+
+
+void rng_fill_u32(uint32_t* out, size_t count, uint64_t seed, int numThreads)
+{
+	rng_fill_bytes(out, count * sizeof(uint32_t), seed, numThreads);
+}
+
+
+void rng_fill_u64(uint64_t* out, size_t count, uint64_t seed, int numThreads)
+{
+	rng_fill_bytes(out, count * sizeof(uint64_t), seed, numThreads);
+}
+
+
+void rng_fill_range_i32(int* out, size_t count, int min, int max, uint64_t seed, int numThreads)
+{
+	if (min > max) { int t = min; min = max; max = t; }
+	fill_job job = { FILL_RANGE_I32, out, count, seed, min, (uint64_t)((int64_t)max - min) + 1 };
+	fill_run(&job, numThreads);
+}
+
+
+void rng_fill_range_i64(int64_t* out, size_t count, int64_t min, int64_t max, uint64_t seed, int numThreads)
+{
+	if (min > max) { int64_t t = min; min = max; max = t; }
+	// the full int64 range wraps around to 0, which fill_block treats as "all values"
+	fill_job job = { FILL_RANGE_I64, out, count, seed, min, (uint64_t)max - (uint64_t)min + 1 };
+	fill_run(&job, numThreads);
+}
+
+
+void rng_fill_zipf_i32(int* out, size_t count, int n, double s, uint64_t seed, int numThreads)
+{
+	fill_job job = { FILL_ZIPF_I32, out, count, seed };
+	rng_zipf_init(&job.zipf, n, s);
+	fill_run(&job, numThreads);
+}
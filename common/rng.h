@@ -0,0 +1,124 @@
+/**
+ * Fast random numbers for generating test data
+ *
+ * rng_xoshiro is xoshiro256** (Blackman & Vigna): a small, fast sequential generator.
+ * rng_at() is counter-based: value @index of stream @seed, computed directly
+ * (SplitMix64), so any thread can produce any part of a stream.
+ *
+ * The rng_fill_ functions split the output into fixed blocks, each seeded from rng_at()
+ * with its block index, so the same seed gives the same output for any thread count.
+ * None of this is cryptographically secure.
+ */
+#pragma once
+#include <stddef.h> // size_t
+#include <stdint.h> // uint64_t, int64_t
+
+#if _MSC_VER && _WIN64
+	#include <intrin.h> // __umulh
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+// SplitMix64: value @index of stream @seed, every index gives a different value
+static inline uint64_t rng_at(uint64_t seed, uint64_t index)
+{
+	uint64_t z = seed + (index + 1) * 0x9e3779b97f4a7c15ull;
+	z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+	z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+	return z ^ (z >> 31);
+}
+
+
+typedef struct _rng_xoshiro {
+	uint64_t s[4];
+} rng_xoshiro;
+
+
+void rng_seed(rng_xoshiro* r, uint64_t seed);
+
+// advances @r by 2^128 values: seed once, then jump once per thread for separate streams
+void rng_jump(rng_xoshiro* r);
+
+static inline uint64_t rng_next(rng_xoshiro* r)
+{
+	uint64_t* s = r->s;
+	uint64_t x = s[1] * 5;
+	uint64_t result = ((x << 7) | (x >> 57)) * 9;
+	uint64_t t = s[1] << 17;
+	s[2] ^= s[0];
+	s[3] ^= s[1];
+	s[1] ^= s[2];
+	s[0] ^= s[3];
+	s[2] ^= t;
+	s[3] = (s[3] << 45) | (s[3] >> 19);
+	return result;
+}
+
+
+// maps a random 64-bit value to [0, range) with a multiply instead of a division;
+// the bias is at most range / 2^64
+static inline uint64_t rng_bounded(uint64_t random, uint64_t range)
+{
+#if __SIZEOF_INT128__
+	return (uint64_t)(((unsigned __int128)random * range) >> 64);
+#elif _MSC_VER && _WIN64
+	return __umulh(random, range);
+#else
+	uint64_t rl = (uint32_t)random, rh = random >> 32;
+	uint64_t gl = (uint32_t)range,  gh = range >> 32;
+	uint64_t mid = rh * gl + ((rl * gl) >> 32);
+	uint64_t mid2 = rl * gh + (uint32_t)mid;
+	return rh * gh + (mid >> 32) + (mid2 >> 32);
+#endif
+}
+
+
+// a random 64-bit value as a double in [0, 1)
+static inline double rng_unit(uint64_t random)
+{
+	return (double)(random >> 11) * (1.0 / 9007199254740992.0); // 53 bits / 2^53
+}
+
+
+/**
+ * Zipf distribution over ranks [0, n): rank k has weight 1 / (k+1)^s, so a few ranks
+ * are very common and most are rare, like hot keys or popular IDs.
+ * Rejection-inversion sampling (Hoermann & Derflinger): O(1) per sample, no tables.
+ */
+typedef struct _rng_zipf {
+	int    n;
+	double s;
+	double hIntegralX1;
+	double hIntegralN;
+	double cutoff;
+} rng_zipf;
+
+// @n >= 1 ranks, exponent @s > 0 (around 1 for most real-world key popularity)
+void rng_zipf_init(rng_zipf* z, int n, double s);
+int  rng_zipf_next(const rng_zipf* z, rng_xoshiro* r);
+
+
+
+/**
+ * Bulk fills: deterministic for a seed, whatever @numThreads is
+ * numThreads: 1 runs on the calling thread only, <= 0 uses all hardware threads
+ */
+void rng_fill_bytes(void* out, size_t size, uint64_t seed, int numThreads);
+void rng_fill_u32(uint32_t* out, size_t count, uint64_t seed, int numThreads);
+void rng_fill_u64(uint64_t* out, size_t count, uint64_t seed, int numThreads);
+
+// uniform values in [min, max], both inclusive, swapped if min > max;
+// any span works, up to INT_MIN..INT_MAX and INT64_MIN..INT64_MAX
+void rng_fill_range_i32(int* out, size_t count, int min, int max, uint64_t seed, int numThreads);
+void rng_fill_range_i64(int64_t* out, size_t count, int64_t min, int64_t max, uint64_t seed, int numThreads);
+
+// Zipf ranks in [0, n), see rng_zipf; kernels.hash_u32() the ranks to scatter them like IDs
+void rng_fill_zipf_i32(int* out, size_t count, int n, double s, uint64_t seed, int numThreads);
+
+
+#ifdef __cplusplus
+}
+#endif
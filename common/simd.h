@@ -0,0 +1,24 @@
+/**
+ * Compile-time SIMD availability for the course examples
+ * SSE2 is part of the x86-64 baseline, so 64-bit x86 builds always have it
+ */
+#pragma once
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+	#define SIMD_SSE2 1
+#else
+	#define SIMD_SSE2 0
+#endif
+
+#if defined(__SSE4_1__) || defined(__AVX__)
+	#define SIMD_SSE41 1
+#else
+	#define SIMD_SSE41 0
+#endif
+
+#if SIMD_SSE2
+	#include <emmintrin.h> // SSE2
+#endif
+#if SIMD_SSE41
+	#include <smmintrin.h> // SSE4.1
+#endif
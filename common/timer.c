@@ -0,0 +1,34 @@
+/**
+ * High resolution monotonic timer shared by the course examples
+ */
+#if !_WIN32 && !defined(_POSIX_C_SOURCE)
+	#define _POSIX_C_SOURCE 200809L // clock_gettime with -std=c11
+#endif
+#include "timer.h"
+
+#if _WIN32
+	#define WIN32_LEAN_AND_MEAN
+	#include <Windows.h>
+#else
+	#include <time.h>
+#endif
+
+
+double timer_now(void)
+{
+#if _WIN32
+	static double period = 0.0;
+	LARGE_INTEGER t;
+	if (period == 0.0) {
+		LARGE_INTEGER freq;
+		QueryPerformanceFrequency(&freq);
+		period = 1.0 / (double)freq.QuadPart;
+	}
+	QueryPerformanceCounter(&t);
+	return (double)t.QuadPart * period;
+#else
+	struct timespec t;
+	clock_gettime(CLOCK_MONOTONIC, &t);
+	return (double)t.tv_sec + (double)t.tv_nsec * 1e-9;
+#endif
+}
@@ -0,0 +1,17 @@
+/**
+ * High resolution monotonic timer shared by the course examples
+ */
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+// monotonic time in seconds; only the difference between two calls is meaningful
+double timer_now(void);
+
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,380 @@
+/**
+ * Low-overhead tracing for the course examples
+ * Uses C99 dialect, so compile with -std=gnu99 or -std=c99
+ */
+#if !_WIN32 && !defined(_POSIX_C_SOURCE)
+	#define _POSIX_C_SOURCE 200809L // nanosleep with -std=c11
+#endif
+#include "trace.h"
+#include <stdio.h>  // FILE, fprintf, printf
+#include <stdlib.h> // getenv, malloc, calloc, free
+#include <string.h> // strlen, memcpy
+
+#if _WIN32
+	#define WIN32_LEAN_AND_MEAN
+	#include <Windows.h>
+	#define TRACE_THREAD_LOCAL __declspec(thread)
+#else
+	#include <pthread.h>
+	#include <time.h> // nanosleep
+	#define TRACE_THREAD_LOCAL _Thread_local
+#endif
+
+
+#define TRACE_RING_SIZE 16384 // events per thread (512KB), must be a power of 2
+
+enum trace_event_type { EVENT_ZONE, EVENT_COUNTER };
+
+typedef struct _trace_event {
+	const char* name;
+	double time;  // timer_now() at the start of a zone or of a counter sample
+	double value; // end of a zone or the counter value
+	int    type;
+	int    tid;   // thread that recorded it, a reused ring holds several
+} trace_event;
+
+typedef struct _trace_ring {
+	struct _trace_ring* next;
+	int          tid;
+	volatile int owned;  // a live thread records into this ring
+	volatile unsigned head; // events recorded so far, only the owner writes it, and
+	                        // only after the event is complete (release)
+	unsigned     start;  // head when the current trace started, only trace_start/stop use it
+	trace_event  events[TRACE_RING_SIZE];
+} trace_ring;
+
+
+volatile int trace_enabled = 0;
+static double traceStart;
+static char*  tracePath;
+static int    mainTid;
+static void* volatile rings;  // every ring ever created, newest first
+static volatile int ringCount;
+static TRACE_THREAD_LOCAL trace_ring* localRing;
+
+
+
+
+
+
+/**
+ * Per-thread rings
+ * parallel_run() starts new threads every time, so the ring of an exited thread
+ * goes back to the pool via a thread-exit destructor instead of being leaked
+ */
+static void ring_release(void* ring)
+{
+	if (ring)
+		atomic_store_int(&((trace_ring*)ring)->owned, 0);
+}
+
+#if _WIN32
+static DWORD ringKey = FLS_OUT_OF_INDEXES;
+static INIT_ONCE ringKeyOnce = INIT_ONCE_STATIC_INIT;
+static void NTAPI ring_release_fls(void* ring)
+{
+	ring_release(ring);
+}
+static BOOL CALLBACK ring_key_create(PINIT_ONCE once, PVOID param, PVOID* context)
+{
+	ringKey = FlsAlloc(ring_release_fls);
+	return TRUE;
+}
+#else
+static pthread_key_t ringKey;
+static pthread_once_t ringKeyOnce = PTHREAD_ONCE_INIT;
+static void ring_key_create(void)
+{
+	pthread_key_create(&ringKey, ring_release);
+}
+#endif
+
+
+static trace_ring* ring_acquire(void)
+{
+	trace_ring* ring = NULL;
+	for (trace_ring* r = atomic_load_ptr(&rings); r && !ring; r = r->next)
+		if (atomic_load_int(&r->owned) == 0 && atomic_cas_int(&r->owned, 0, 1) == 0)
+			ring = r; // its old events stay in front of the new ones
+
+	if (ring) // a new thread gets a new track, even in a reused ring
+		ring->tid = atomic_fetch_add_int(&ringCount, 1) + 1;
+	else
+	{
+		if (!(ring = calloc(1, sizeof(trace_ring))))
+			return NULL;
+		ring->owned = 1;
+		ring->tid = atomic_fetch_add_int(&ringCount, 1) + 1;
+		void* head;
+		do {
+			head = atomic_load_ptr(&rings);
+			ring->next = head;
+		} while (atomic_cas_ptr(&rings, head, ring) != head);
+	}
+
+#if _WIN32
+	InitOnceExecuteOnce(&ringKeyOnce, ring_key_create, NULL, NULL);
+	if (ringKey != FLS_OUT_OF_INDEXES)
+		FlsSetValue(ringKey, ring);
+#else
+	pthread_once(&ringKeyOnce, ring_key_create);
+	pthread_setspecific(ringKey, ring);
+#endif
+	return localRing = ring;
+}
+
+
+// the slot to fill, it stays invisible to trace_stop() until publish_event()
+static trace_event* next_event(void)
+{
+	trace_ring* ring = localRing ? localRing : ring_acquire();
+	if (!ring)
+		return NULL;
+	trace_event* e = &ring->events[ring->head & (TRACE_RING_SIZE - 1)];
+	e->tid = ring->tid;
+	return e;
+}
+
+
+static void publish_event(void)
+{
+	atomic_store_uint(&localRing->head, localRing->head + 1);
+}
+
+
+void trace_record_zone(const char* name, double start, double end)
+{
+	trace_event* e;
+	if (!atomic_load_int(&trace_enabled) || !(e = next_event()))
+		return; // a zone that outlived trace_stop()
+	e->name = name;
+	e->time = start;
+	e->value = end;
+	e->type = EVENT_ZONE;
+	publish_event();
+}
+
+
+void trace_record_counter(const char* name, double value)
+{
+	trace_event* e;
+	if (!atomic_load_int(&trace_enabled) || !(e = next_event()))
+		return;
+	e->name = name;
+	e->time = timer_now();
+	e->value = value;
+	e->type = EVENT_COUNTER;
+	publish_event();
+}
+
+
+
+
+
+
+/**
+ * Output in the Chrome Trace Event Format: X events for zones, C for counters
+ */
+static void write_name(FILE* f, const char* name)
+{
+	for (; *name; ++name)
+	{
+		if (*name == '"' || *name == '\\') fprintf(f, "\\%c", *name);
+		else if ((unsigned char)*name < ' ') fprintf(f, "\\u%04x", *name);
+		else fputc(*name, f);
+	}
+}
+
+
+static void write_thread_name(FILE* f, int tid)
+{
+	char name[32];
+	if (tid == mainTid) sprintf(name, "main");
+	else                sprintf(name, "thread %d", tid);
+	fprintf(f, "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":\"%s\"}}",
+	        tid, name);
+}
+
+
+static void write_event(FILE* f, const trace_event* e)
+{
+	int tid = e->tid;
+	fprintf(f, "{\"name\":\"");
+	write_name(f, e->name);
+	if (e->type == EVENT_ZONE)
+		fprintf(f, "\",\"ph\":\"X\",\"pid\":1,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f}",
+		        tid, (e->time - traceStart) * 1e6, (e->value - e->time) * 1e6);
+	else
+		fprintf(f, "\",\"ph\":\"C\",\"pid\":1,\"tid\":%d,\"ts\":%.3f,\"args\":{\"value\":%.15g}}",
+		        tid, (e->time - traceStart) * 1e6, e->value);
+}
+
+
+int trace_start(const char* path)
+{
+	if (!path)
+		path = getenv("TRACE");
+	if (!path || !*path || atomic_load_int(&trace_enabled))
+		return 0;
+
+	size_t len = strlen(path) + 1;
+	if (!(tracePath = malloc(len)))
+		return 0;
+	memcpy(tracePath, path, len);
+	// a previous trace was already written; only the owners write head, so the
+	// rings of live threads aren't reset, their older events are skipped instead
+	for (trace_ring* r = atomic_load_ptr(&rings); r; r = r->next)
+		r->start = atomic_load_uint(&r->head);
+	trace_ring* ring = localRing ? localRing : ring_acquire();
+	mainTid = ring ? ring->tid : 0;
+	traceStart = timer_now();
+	atomic_store_int(&trace_enabled, 1);
+	return 1;
+}
+
+
+void trace_stop(void)
+{
+	if (!atomic_load_int(&trace_enabled))
+		return;
+	atomic_store_int(&trace_enabled, 0);
+
+	FILE* f = fopen(tracePath, "w");
+	if (!f)
+	{
+		fprintf(stderr, "trace: can't write %s\n", tracePath);
+		free(tracePath);
+		tracePath = NULL;
+		return;
+	}
+
+	unsigned written = 0, overwritten = 0;
+	fprintf(f, "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n");
+	int first = 1;
+	for (trace_ring* r = atomic_load_ptr(&rings); r; r = r->next)
+	{
+		// events before head are complete; a thread that saw trace_enabled just
+		// before it was cleared may still be filling the slot at head, which in a
+		// full ring is also the oldest one, so that one is left out
+		unsigned head = atomic_load_uint(&r->head);
+		unsigned count = head - r->start < TRACE_RING_SIZE ? head - r->start : TRACE_RING_SIZE - 1;
+		int named = 0; // the threads of one ring come one after the other
+		for (unsigned i = head - count; i != head; ++i)
+		{
+			const trace_event* e = &r->events[i & (TRACE_RING_SIZE - 1)];
+			if (e->tid != named)
+			{
+				fprintf(f, first ? "" : ",\n");
+				write_thread_name(f, e->tid);
+				named = e->tid;
+				first = 0;
+			}
+			fprintf(f, ",\n");
+			write_event(f, e);
+		}
+		written += count;
+		overwritten += head - r->start - count;
+	}
+	fprintf(f, "\n]}\n");
+	fclose(f);
+
+	fprintf(stderr, "trace: %u events written to %s\n", written, tracePath);
+	if (overwritten)
+		fprintf(stderr, "trace: the oldest %u events were overwritten, the rings hold %d per thread\n",
+		        overwritten, TRACE_RING_SIZE);
+	free(tracePath);
+	tracePath = NULL;
+}
+
+
+
+
+
+
+/**
+ * Progress sampler
+ */
+static void sleep_ms(int ms)
+{
+#if _WIN32
+	Sleep(ms);
+#else
+	struct timespec t = { 0, ms * 1000000L };
+	nanosleep(&t, NULL);
+#endif
+}
+
+
+#if _WIN32
+static DWORD WINAPI progress_entry(LPVOID param)
+#else
+static void* progress_entry(void* param)
+#endif
+{
+	trace_progress* p = param;
+	int shown = -1, sampled = -1;
+	for (;;)
+	{
+		int stop = atomic_load_int(&p->stop);
+		int done = atomic_load_int(&p->done);
+		int percent = p->total > 0 ? (int)((long long)done * 100 / p->total) : 100;
+		if (percent != shown)
+		{
+			printf(shown < 0 ? "%3d%%" : "\b\b\b\b%3d%%", percent);
+			fflush(stdout);
+			shown = percent;
+		}
+		if (done != sampled)
+		{
+			trace_counter(p->name, done);
+			sampled = done;
+		}
+		if (stop)
+			break;
+		sleep_ms(10);
+	}
+	printf("\b\b\b\b    \b\b\b\b"); // erase the percentage
+	fflush(stdout);
+	return 0;
+}
+
+
+trace_progress* trace_progress_start(const char* name, int total)
+{
+	trace_progress* p = calloc(1, sizeof(trace_progress));
+	if (!p)
+		return NULL; // the loop runs without progress, the other functions accept NULL
+	p->name = name;
+	p->total = total;
+#if _WIN32
+	p->thread = CreateThread(NULL, 0, progress_entry, p, 0, NULL);
+#else
+	pthread_t* thread = malloc(sizeof(pthread_t));
+	if (thread && pthread_create(thread, NULL, progress_entry, p) != 0)
+	{
+		free(thread);
+		thread = NULL;
+	}
+	p->thread = thread;
+#endif
+	return p;
+}
+
+
+void trace_progress_stop(trace_progress* p)
+{
+	if (!p)
+		return;
+	if (p->thread)
+	{
+		atomic_store_int(&p->stop, 1);
+	#if _WIN32
+		WaitForSingleObject(p->thread, INFINITE);
+		CloseHandle(p->thread);
+	#else
+		pthread_join(*(pthread_t*)p->thread, NULL);
+		free(p->thread);
+	#endif
+	}
+	free(p);
+}
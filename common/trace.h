@@ -0,0 +1,109 @@
+/**
+ * Low-overhead tracing for the course examples, viewable in chrome://tracing or
+ * https://ui.perfetto.dev
+ *
+ * Every thread records into its own lock-free ring buffer (the oldest events are
+ * overwritten when it's full), and trace_stop() writes them all as Chrome trace JSON.
+ * While tracing is off a zone or counter costs one load and a branch; building with
+ * -DTRACE_DISABLED=1 removes them completely.
+ *
+ *     trace_start(NULL);                        // traces if TRACE=file.json is set
+ *     trace_zone z = trace_zone_begin("sort");  // names must be string literals
+ *     ...
+ *     trace_zone_end(z);
+ *     trace_counter("items", count);
+ *     trace_stop();                             // writes the file
+ *
+ * trace_progress reports the progress of a long loop from a sampler thread, so the
+ * loop itself only stores a counter.
+ */
+#pragma once
+#include <stddef.h>   // NULL
+#include "atomics.h"  // atomic_load_int, atomic_store_int
+#include "timer.h"    // timer_now
+
+#ifndef TRACE_DISABLED
+	#define TRACE_DISABLED 0
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+// starts tracing into @path, or into $TRACE if @path is NULL; returns 0 and stays
+// off if neither is set
+int trace_start(const char* path);
+
+// writes the trace and turns tracing off; a thread still recording loses at most the
+// event it was writing, join the threads first for a complete trace
+void trace_stop(void);
+
+
+extern volatile int trace_enabled;
+
+// slow paths of the inline functions below
+void trace_record_zone(const char* name, double start, double end);
+void trace_record_counter(const char* name, double value);
+
+
+typedef struct _trace_zone {
+	const char* name; // NULL if tracing was off when the zone began
+	double start;
+} trace_zone;
+
+static inline trace_zone trace_zone_begin(const char* name)
+{
+	trace_zone zone = { NULL, 0.0 };
+	if (!TRACE_DISABLED && atomic_load_int(&trace_enabled)) {
+		zone.name = name;
+		zone.start = timer_now();
+	}
+	return zone;
+}
+
+static inline void trace_zone_end(trace_zone zone)
+{
+	if (!TRACE_DISABLED && zone.name)
+		trace_record_zone(zone.name, zone.start, timer_now());
+}
+
+// a value over time, e.g. a queue length; shown as a graph per @name
+static inline void trace_counter(const char* name, double value)
+{
+	if (!TRACE_DISABLED && atomic_load_int(&trace_enabled))
+		trace_record_counter(name, value);
+}
+
+
+
+/**
+ * Progress of a loop over @total items: prints "42%" in place on stdout a few times
+ * a second and, while tracing, records it as the counter @name
+ */
+typedef struct _trace_progress {
+	const char*  name;
+	int          total;
+	volatile int done;
+	volatile int stop;
+	void*        thread;
+} trace_progress;
+
+// starts the sampler thread; prints nothing if it can't be started,
+// returns NULL if out of memory (trace_progress_set/stop accept that)
+trace_progress* trace_progress_start(const char* name, int total);
+
+// called from the loop: a single store
+static inline void trace_progress_set(trace_progress* p, int done)
+{
+	if (p)
+		atomic_store_int(&p->done, done);
+}
+
+// stops the sampler, erases the percentage and frees @p
+void trace_progress_stop(trace_progress* p);
+
+
+#ifdef __cplusplus
+}
+#endif
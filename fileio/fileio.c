@@ -7,6 +7,9 @@
 #include <stdio.h>     // printf / fopen / fread / ...
 #include <sys/stat.h>  // fstat
 #include <stdint.h>    // uint64_t
+#include <string.h>    // strcmp
+#include "bench.h"     // bench_begin, bench_run, bench_end
+#include "trace.h"     // trace_zone_begin, trace_zone_end, trace_counter
 
 
 
@@ -78,12 +81,53 @@ uint64_t fnv64(void* data, size_t numBytes)
 }
 
 
+typedef struct _fnv_bench {
+	char*    data;
+	size_t   size;
+	uint64_t hash;
+} fnv_bench;
+
+static void bench_fnv64(void* arg)
+{
+	fnv_bench* b = arg;
+	b->hash = fnv64(b->data, b->size);
+}
+
+
+// `make bench`: fnv64 on a page, a typical file and one much larger than the caches
+static int run_benchmarks(void)
+{
+	static const struct { const char* name; size_t size; } cases[] = {
+		{ "fnv64 4KB", 4 << 10 }, { "fnv64 1MB", 1 << 20 }, { "fnv64 64MB", 64 << 20 },
+	};
+	size_t maxSize = 64 << 20;
+	char* data = malloc(maxSize);
+	for (size_t i = 0; i < maxSize; ++i)
+		data[i] = (char)(i * 2654435761u >> 13);
+
+	bench_begin("fileio");
+	for (int i = 0; i < (int)(sizeof cases / sizeof cases[0]); ++i)
+	{
+		fnv_bench b = { data, cases[i].size, 0 };
+		bench_run(cases[i].name, bench_fnv64, &b, (double)b.size);
+	}
+	free(data);
+	return bench_end(); // number of regressions against BENCH_BASELINE
+}
+
+
 int main(int argc, char** argv)
 {
+	if (argc > 1 && strcmp(argv[1], "--bench") == 0)
+		return run_benchmarks() ? 1 : 0;
+
+	trace_start(NULL); // TRACE=file.json writes a Chrome trace of the run
 	const char srcFile[] = __FILE__;
 	printf("Filesize of %s:\n", srcFile);
 	printf("fsize stat  = %d\n", filesize_by_stat(srcFile));
+#if _WIN32
 	printf("fsize win32 = %d\n", filesize_by_win32(srcFile));
+#endif
 
 	FILE* f = fopen(srcFile, "rb");
 	if (f)
@@ -95,7 +139,11 @@ int main(int argc, char** argv)
 
 		char* buffer = malloc(size);        // allocate buffer
 		fread(buffer, size, 1, f);          // read all data & update size
-		printf("fnv64(\"%s\") = 0x%016llx\n", srcFile, fnv64(buffer, size)); // work with data
+		trace_counter("fnv64 bytes", size); // traced here, so --bench times fnv64 alone
+		trace_zone zone = trace_zone_begin("fnv64");
+		uint64_t hash = fnv64(buffer, size); // work with data
+		trace_zone_end(zone);
+		printf("fnv64(\"%s\") = 0x%016llx\n", srcFile, hash);
 
 		free(buffer);       // free the allocated buffer
 		fclose(f);          // close the file
@@ -111,13 +159,18 @@ int main(int argc, char** argv)
 
 		char* buffer = malloc(size);
 		ReadFile(hFile, buffer, size, &size, 0); // read via winapi (much faster than fread on win32)
-		printf("fnv64(\"%s\") = 0x%016llx\n", srcFile, fnv64(buffer, size)); // work with data
+		trace_counter("fnv64 bytes", size);
+		trace_zone zone = trace_zone_begin("fnv64");
+		uint64_t hash = fnv64(buffer, size); // work with data
+		trace_zone_end(zone);
+		printf("fnv64(\"%s\") = 0x%016llx\n", srcFile, hash);
 
 		free(buffer);       // free the allocated buffer
 		CloseHandle(hFile); // close win32 file handle
 	}
 #endif
 
+	trace_stop();
 	system("pause");
 	return 0;
 }
\ No newline at end of file
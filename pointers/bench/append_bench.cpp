@@ -0,0 +1,140 @@
+/**
+ * Benchmark: lock-free civ_add() vs a mutex-guarded iv_add() under contention
+ * Usage: append_bench [totalItems]   (default 8M items, split evenly between threads)
+ */
+#include "civector.h"
+#include "ivector.h"
+#include "parallel.h"
+#include "timer.h"
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+
+
+struct append_job {
+    civector*  civ;
+    ivector*   iv;
+    std::mutex lock;
+    int        perThread;
+};
+
+
+static void civ_task(void* arg, int threadIdx, int /*numThreads*/)
+{
+    append_job* job = (append_job*)arg;
+    int base = threadIdx * job->perThread;
+    for (int i = 0; i < job->perThread; ++i)
+        civ_add(job->civ, base + i);
+}
+
+
+static void mutex_task(void* arg, int threadIdx, int /*numThreads*/)
+{
+    append_job* job = (append_job*)arg;
+    int base = threadIdx * job->perThread;
+    for (int i = 0; i < job->perThread; ++i)
+    {
+        std::lock_guard<std::mutex> guard(job->lock);
+        iv_add(job->iv, base + i);
+    }
+}
+
+
+// every value 0..n-1 was appended exactly once
+static bool check_items(ivector* iv, int n)
+{
+    if (iv->size != n)
+        return false;
+    iv_sort(iv);
+    for (int i = 0; i < n; ++i)
+        if (iv->data[i] != i)
+            return false;
+    return true;
+}
+
+
+struct reader_job {
+    civector* civ;
+    int       perThread;
+    int       total;
+    bool      ok;
+};
+
+
+// thread 0 keeps reading the published prefix while threads 1..N append
+static void reader_task(void* arg, int threadIdx, int /*numThreads*/)
+{
+    reader_job* job = (reader_job*)arg;
+    if (threadIdx > 0)
+    {
+        int base = (threadIdx - 1) * job->perThread;
+        for (int i = 0; i < job->perThread; ++i)
+            civ_add(job->civ, base + i);
+        return;
+    }
+
+    int seen = 0;
+    long long sum = 0;
+    while (seen < job->total)
+    {
+        int published = civ_published(job->civ);
+        if (published < seen)
+            job->ok = false; // the published prefix must never shrink
+        for (; seen < published; ++seen)
+            sum += civ_at(job->civ, seen);
+    }
+    job->ok = job->ok && sum == (long long)job->total * (job->total - 1) / 2;
+}
+
+
+static bool check_concurrent_readers(int writers, int perThread)
+{
+    reader_job job = { civ_new(), perThread, writers * perThread, true };
+    parallel_run(writers + 1, reader_task, &job);
+    civ_free(job.civ);
+    return job.ok;
+}
+
+
+int main(int argc, char** argv)
+{
+    int total = argc > 1 ? atoi(argv[1]) : 8 * 1000 * 1000;
+    printf("%d appends split across threads (%d hardware threads)\n", total, parallel_hw_threads());
+    printf("threads   civ_add ms   mutex+iv_add ms   speedup\n");
+
+    for (int threads = 1; threads <= 64; threads *= 2)
+    {
+        append_job job;
+        job.perThread = total / threads;
+        int n = job.perThread * threads;
+
+        job.civ = civ_new();
+        double start = timer_now();
+        parallel_run(threads, civ_task, &job);
+        double tciv = timer_now() - start;
+
+        job.iv = iv_new();
+        start = timer_now();
+        parallel_run(threads, mutex_task, &job);
+        double tmutex = timer_now() - start;
+
+        ivector* frozen = civ_freeze(job.civ);
+        if (!check_items(frozen, n) || !check_items(job.iv, n))
+        {
+            fprintf(stderr, "error: lost or duplicated items with %d threads\n", threads);
+            return 1;
+        }
+        printf("%7d %12.2f %17.2f %9.2fx\n", threads, tciv * 1e3, tmutex * 1e3, tmutex / tciv);
+
+        iv_free(frozen);
+        iv_free(job.iv);
+        civ_free(job.civ);
+    }
+
+    if (!check_concurrent_readers(8, total / 8))
+    {
+        fprintf(stderr, "error: published prefix is inconsistent\n");
+        return 1;
+    }
+    return 0;
+}
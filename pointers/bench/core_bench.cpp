@@ -0,0 +1,78 @@
+/**
+ * Benchmark: the course's hot paths through common/bench.h, for run-to-run comparisons
+ * my_strcpy1/2/3, the my_strcpy kernel and libc strcpy at three string lengths,
+ * iv_add() growing a vector vs filling a reserved one
+ * Compare against an earlier run: BENCH_FORMAT=csv BENCH_OUT=base.csv make bench,
+ * then BENCH_BASELINE=base.csv make bench (see common/bench.h)
+ */
+#include "bench.h"
+#include "mystring.h"
+#include "ivector.h"
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+
+struct copy_case {
+    void (*copy)(char* dst, const char* src);
+    const char* src;
+    char* dst;
+};
+
+static void bench_copy(void* arg)
+{
+    copy_case* c = (copy_case*)arg;
+    c->copy(c->dst, c->src);
+}
+
+
+struct add_case {
+    int count;
+    bool reserve;
+};
+
+static volatile int sink;
+
+static void bench_add(void* arg)
+{
+    add_case* c = (add_case*)arg;
+    ivector* iv = iv_new();
+    if (c->reserve)
+        iv_reserve(iv, c->count);
+    for (int i = 0; i < c->count; ++i)
+        iv_add(iv, i);
+    sink = iv->size;
+    iv_free(iv);
+}
+
+
+int main()
+{
+    static const struct { const char* name; void (*copy)(char*, const char*); } copies[] = {
+        { "my_strcpy1",  my_strcpy1 },
+        { "my_strcpy2",  my_strcpy2 },
+        { "my_strcpy3",  my_strcpy3 },
+        { "my_strcpy",   [](char* d, const char* s) { my_strcpy(d, s); } },
+        { "libc strcpy", [](char* d, const char* s) { strcpy(d, s); } },
+    };
+    static const size_t lengths[] = { 16, 256, 4096 };
+
+    bench_begin("pointers");
+    for (size_t length : lengths)
+    {
+        std::string src(length, 'x');
+        std::vector<char> dst(length + 1);
+        for (const auto& c : copies)
+        {
+            copy_case arg = { c.copy, src.c_str(), dst.data() };
+            std::string name = std::string(c.name) + " " + std::to_string(length) + "B";
+            bench_run(name.c_str(), bench_copy, &arg, (double)length);
+        }
+    }
+
+    add_case grow = { 1 << 20, false }, reserved = { 1 << 20, true };
+    bench_run("iv_add 1M", bench_add, &grow, sizeof(int) * (double)grow.count);
+    bench_run("iv_add 1M reserved", bench_add, &reserved, sizeof(int) * (double)reserved.count);
+    return bench_end() ? 1 : 0; // regressions against BENCH_BASELINE fail `make bench`
+}
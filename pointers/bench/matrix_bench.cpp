@@ -0,0 +1,175 @@
+/**
+ * Benchmark: contiguous tiled vs contiguous naive vs pointer-to-row matrices
+ * Usage: matrix_bench [maxTransposeSize] [maxMultiplySize]   (default 8192 and 1024)
+ * Naive multiply is O(n^3) with a column walk, so it is capped at 1024 regardless
+ */
+#include "matrix.h"
+#include "parallel.h"
+#include "timer.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cmath>
+
+
+// the ptr2arr layout from part6(): every row is its own allocation
+struct row_matrix {
+    float** rows;
+    int n;
+};
+
+static row_matrix rows_new(int n)
+{
+    row_matrix m = { (float**)malloc(sizeof(float*) * n), n };
+    for (int i = 0; i < n; ++i)
+        m.rows[i] = (float*)malloc(sizeof(float) * n);
+    return m;
+}
+static void rows_free(row_matrix& m)
+{
+    for (int i = 0; i < m.n; ++i)
+        free(m.rows[i]);
+    free(m.rows);
+}
+static void rows_transpose(row_matrix& dst, const row_matrix& src)
+{
+    for (int i = 0; i < src.n; ++i)
+        for (int j = 0; j < src.n; ++j)
+            dst.rows[j][i] = src.rows[i][j];
+}
+static void rows_multiply(row_matrix& c, const row_matrix& a, const row_matrix& b)
+{
+    for (int i = 0; i < a.n; ++i)
+    for (int j = 0; j < a.n; ++j)
+    {
+        float sum = 0.0f;
+        for (int k = 0; k < a.n; ++k)
+            sum += a.rows[i][k] * b.rows[k][j];
+        c.rows[i][j] = sum;
+    }
+}
+
+
+static void fill_random(matrix& m, row_matrix& r)
+{
+    for (int i = 0; i < m.rows; ++i)
+        for (int j = 0; j < m.cols; ++j)
+            *mat_at(&m, i, j) = r.rows[i][j] = (float)(rand() % 17 - 8) * 0.125f;
+}
+
+
+// runs @fn until at least ~0.2s passed (at least once), returns seconds per run
+template<class Fn>
+static double seconds_per_run(Fn fn)
+{
+    int runs = 0;
+    double start = timer_now(), elapsed;
+    do {
+        fn();
+        ++runs;
+        elapsed = timer_now() - start;
+    } while (elapsed < 0.2);
+    return elapsed / runs;
+}
+
+
+static int failures = 0;
+static void check(bool ok, const char* what, int n)
+{
+    if (!ok && ++failures <= 10)
+        fprintf(stderr, "FAIL %s at n=%d\n", what, n);
+}
+
+
+static bool same(const matrix& m, const row_matrix& r, float tolerance)
+{
+    for (int i = 0; i < m.rows; ++i)
+        for (int j = 0; j < m.cols; ++j)
+            if (std::fabs(*mat_at(&m, i, j) - r.rows[i][j]) > tolerance)
+                return false;
+    return true;
+}
+
+
+static void bench_transpose(int n, int threads)
+{
+    matrix a = mat_new(n, n), t = mat_new(n, n);
+    row_matrix ra = rows_new(n), rt = rows_new(n);
+    fill_random(a, ra);
+
+    double tRows  = seconds_per_run([&] { rows_transpose(rt, ra); });
+    double tNaive = seconds_per_run([&] { mat_transpose_naive(&t, &a); });
+    check(same(t, rt, 0.0f), "mat_transpose_naive", n);
+    double tTiled = seconds_per_run([&] { mat_transpose(&t, &a, 1); });
+    check(same(t, rt, 0.0f), "mat_transpose", n);
+    double tPar   = seconds_per_run([&] { mat_transpose(&t, &a, threads); });
+    check(same(t, rt, 0.0f), "mat_transpose parallel", n);
+
+    double bytes = 2.0 * n * n * sizeof(float);
+    printf("%6d %12.2f %12.2f %12.2f %12.2f   GB/s\n", n,
+           bytes / tRows * 1e-9, bytes / tNaive * 1e-9, bytes / tTiled * 1e-9, bytes / tPar * 1e-9);
+
+    mat_free(&a); mat_free(&t);
+    rows_free(ra); rows_free(rt);
+}
+
+
+static void bench_multiply(int n, int threads)
+{
+    matrix a = mat_new(n, n), b = mat_new(n, n), c = mat_new(n, n);
+    row_matrix ra = rows_new(n), rb = rows_new(n), rc = rows_new(n);
+    fill_random(a, ra);
+    fill_random(b, rb);
+
+    bool naive = n <= 1024;
+    double tRows  = naive ? seconds_per_run([&] { rows_multiply(rc, ra, rb); }) : 0.0;
+    double tNaive = naive ? seconds_per_run([&] { mat_multiply_naive(&c, &a, &b); }) : 0.0;
+    if (naive) check(same(c, rc, 0.0f), "mat_multiply_naive", n);
+    double tTiled = seconds_per_run([&] { mat_multiply(&c, &a, &b, 1); });
+    // inputs are multiples of 1/8 in [-1, 1], so every partial sum is exact in float
+    if (naive) check(same(c, rc, 0.0f), "mat_multiply", n);
+    double tPar   = seconds_per_run([&] { mat_multiply(&c, &a, &b, threads); });
+    if (naive) check(same(c, rc, 0.0f), "mat_multiply parallel", n);
+
+    double flops = 2.0 * n * n * n * 1e-9;
+    if (naive) printf("%6d %12.2f %12.2f %12.2f %12.2f   GFLOP/s\n", n, flops / tRows, flops / tNaive, flops / tTiled, flops / tPar);
+    else       printf("%6d %12s %12s %12.2f %12.2f   GFLOP/s\n", n, "-", "-", flops / tTiled, flops / tPar);
+
+    mat_free(&a); mat_free(&b); mat_free(&c);
+    rows_free(ra); rows_free(rb); rows_free(rc);
+}
+
+
+int main(int argc, char** argv)
+{
+    int maxTranspose = argc > 1 ? atoi(argv[1]) : 8192;
+    int maxMultiply  = argc > 2 ? atoi(argv[2]) : 1024;
+    int threads = parallel_hw_threads();
+
+    // views share memory: writing through a sub-view must show up in the parent
+    matrix m = mat_new(8, 8);
+    mat_fill(&m, 0.0f);
+    matrix v = mat_view(&m, 2, 3, 4, 4);
+    mat_fill(&v, 1.0f);
+    check(*mat_at(&m, 2, 3) == 1.0f && *mat_at(&m, 5, 6) == 1.0f && *mat_at(&m, 6, 6) == 0.0f, "mat_view", 8);
+    mat_free(&v); // no-op for views
+    mat_free(&m);
+
+    printf("transpose %9s %12s %12s %12s\n", "ptr-rows", "naive", "tiled", "parallel");
+    for (int n = 64; n <= maxTranspose; n *= 2)
+        bench_transpose(n, threads);
+    // odd sizes exercise the tile edges
+    bench_transpose(1000, threads);
+
+    printf("multiply  %9s %12s %12s %12s\n", "ptr-rows", "naive", "tiled", "parallel");
+    for (int n = 64; n <= maxMultiply; n *= 2)
+        bench_multiply(n, threads);
+    bench_multiply(257, threads);
+
+    printf("(%d hardware threads)\n", threads);
+    if (failures)
+    {
+        fprintf(stderr, "%d correctness failures\n", failures);
+        return 1;
+    }
+    return 0;
+}
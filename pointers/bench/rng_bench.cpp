@@ -0,0 +1,173 @@
+/**
+ * Benchmark: rand() vs xoshiro256** vs the bulk rng_fill functions
+ * Checks that fills are the same for every thread count and destination alignment,
+ * that ranges stay in bounds and that Zipf frequencies match 1/(k+1)^s
+ * Usage: rng_bench [megabytes]   (default 256)
+ */
+#include "rng.h"
+#include "kernels.h"
+#include "parallel.h"
+#include "timer.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cmath>
+#include <climits>
+#include <vector>
+
+
+static int failures = 0;
+static void check(bool ok, const char* what)
+{
+    if (!ok && ++failures <= 10)
+        fprintf(stderr, "FAIL %s\n", what);
+}
+
+
+static void check_determinism(int threads)
+{
+    const size_t size = 3 * 1000 * 1000 + 5; // not a multiple of the block size
+    std::vector<char> a(size + 8), b(size + 8);
+    rng_fill_bytes(a.data(), size, 42, 1);
+    for (int t = 2; t <= threads + 1; ++t)
+    {
+        rng_fill_bytes(b.data(), size, 42, t);
+        check(memcmp(a.data(), b.data(), size) == 0, "rng_fill_bytes differs between thread counts");
+    }
+    rng_fill_bytes(b.data() + 3, size, 42, threads); // unaligned destination
+    check(memcmp(a.data(), b.data() + 3, size) == 0, "rng_fill_bytes differs for unaligned output");
+    rng_fill_bytes(b.data(), size, 43, threads);
+    check(memcmp(a.data(), b.data(), size) != 0, "rng_fill_bytes ignores the seed");
+
+    std::vector<int> r1(1000003), r2(1000003);
+    rng_fill_range_i32(r1.data(), r1.size(), -5, 1000, 7, 1);
+    rng_fill_range_i32(r2.data(), r2.size(), -5, 1000, 7, threads + 1);
+    check(r1 == r2, "rng_fill_range_i32 differs between thread counts");
+    rng_fill_zipf_i32(r1.data(), r1.size(), 5000, 1.1, 7, 1);
+    rng_fill_zipf_i32(r2.data(), r2.size(), 5000, 1.1, 7, threads + 1);
+    check(r1 == r2, "rng_fill_zipf_i32 differs between thread counts");
+}
+
+
+static void check_ranges()
+{
+    std::vector<int> v(1 << 20);
+    rng_fill_range_i32(v.data(), v.size(), 5, 5, 1, 0);
+    bool ok = true;
+    for (int x : v) ok &= x == 5;
+    check(ok, "rng_fill_range_i32 [5, 5]");
+
+    int lo = INT_MAX, hi = INT_MIN;
+    rng_fill_range_i32(v.data(), v.size(), INT_MIN, INT_MAX, 2, 0);
+    for (int x : v) { if (x < lo) lo = x; if (x > hi) hi = x; }
+    check(lo < INT_MIN / 2 && hi > INT_MAX / 2, "rng_fill_range_i32 full range");
+
+    std::vector<int> bins(10);
+    rng_fill_range_i32(v.data(), v.size(), -3, 6, 3, 0);
+    ok = true;
+    for (int x : v) { ok &= x >= -3 && x <= 6; if (ok) ++bins[x + 3]; }
+    check(ok, "rng_fill_range_i32 out of bounds");
+    for (int c : bins) // 104857.6 expected per bin, 1% is ~30 standard deviations
+        check(std::fabs(c - v.size() / 10.0) < v.size() / 1000.0, "rng_fill_range_i32 not uniform");
+
+    std::vector<int64_t> w(1 << 16);
+    rng_fill_range_i64(w.data(), w.size(), -1000000000000ll, 1000000000000ll, 4, 0);
+    ok = true;
+    for (int64_t x : w) ok &= x >= -1000000000000ll && x <= 1000000000000ll;
+    check(ok, "rng_fill_range_i64 out of bounds");
+    rng_fill_range_i64(w.data(), w.size(), INT64_MIN, INT64_MAX, 4, 0);
+    int negative = 0;
+    for (int64_t x : w) negative += x < 0;
+    check(std::abs(negative - (int)w.size() / 2) < 1000, "rng_fill_range_i64 full range");
+}
+
+
+static void check_zipf()
+{
+    const int n = 1000;
+    const double s = 1.0;
+    std::vector<int> v(4 << 20), freq(n);
+    rng_fill_zipf_i32(v.data(), v.size(), n, s, 5, 0);
+    bool ok = true;
+    for (int x : v) { ok &= x >= 0 && x < n; if (ok) ++freq[x]; }
+    check(ok, "rng_fill_zipf_i32 out of bounds");
+
+    double norm = 0.0;
+    for (int k = 1; k <= n; ++k) norm += 1.0 / std::pow(k, s);
+    for (int k : { 0, 1, 9, 99, 999 })
+    {
+        double expect = v.size() / std::pow(k + 1, s) / norm;
+        check(std::fabs(freq[k] - expect) < 6 * std::sqrt(expect) + 1, "rng_fill_zipf_i32 frequencies");
+    }
+}
+
+
+static volatile uint64_t sink;
+
+int main(int argc, char** argv)
+{
+    size_t megabytes = argc > 1 ? (size_t)atoi(argv[1]) : 256;
+    int threads = parallel_hw_threads();
+
+    check_determinism(threads);
+    check_ranges();
+    check_zipf();
+    if (failures)
+    {
+        fprintf(stderr, "%d correctness failures\n", failures);
+        return 1;
+    }
+    printf("all rng checks passed (kernels: %s)\n\n", cpu_level_name(kernels_init()));
+
+    size_t bytes = megabytes << 20;
+    size_t count = bytes / sizeof(int);
+    std::vector<int> buf(count);
+    uint32_t* words = (uint32_t*)buf.data();
+    rng_fill_bytes(buf.data(), bytes, 0, 0); // touch every page before timing
+
+    double start = timer_now();
+    for (size_t i = 0; i < count; ++i)
+        buf[i] = rand();
+    double tRand = timer_now() - start;
+
+    rng_xoshiro r;
+    rng_seed(&r, 1);
+    start = timer_now();
+    for (size_t i = 0; i < count; i += 2)
+    {
+        uint64_t x = rng_next(&r);
+        words[i] = (uint32_t)x;
+        words[i + 1] = (uint32_t)(x >> 32);
+    }
+    double tNext = timer_now() - start;
+
+    start = timer_now();
+    rng_fill_u32(words, count, 1, 1);
+    double tFill1 = timer_now() - start;
+    start = timer_now();
+    rng_fill_u32(words, count, 1, threads);
+    double tFillN = timer_now() - start;
+
+    start = timer_now();
+    memset(buf.data(), 1, bytes);
+    double tMemset = timer_now() - start;
+
+    start = timer_now();
+    rng_fill_range_i32(buf.data(), count, 0, 999999, 1, threads);
+    double tRange = timer_now() - start;
+    start = timer_now();
+    rng_fill_zipf_i32(buf.data(), count, 1000000, 1.0, 1, threads);
+    double tZipf = timer_now() - start;
+    sink = buf[count / 2];
+
+    double gb = bytes * 1e-9;
+    printf("%-28s %8.2f GB/s\n", "rand() loop",                 gb / tRand);
+    printf("%-28s %8.2f GB/s\n", "rng_next loop",               gb / tNext);
+    printf("%-28s %8.2f GB/s\n", "rng_fill_u32 1 thread",       gb / tFill1);
+    printf("%-28s %8.2f GB/s\n", "rng_fill_u32 all threads",    gb / tFillN);
+    printf("%-28s %8.2f GB/s\n", "memset (bandwidth)",          gb / tMemset);
+    printf("%-28s %8.2f Mvalues/s\n", "rng_fill_range_i32",     count / tRange * 1e-6);
+    printf("%-28s %8.2f Mvalues/s\n", "rng_fill_zipf_i32",      count / tZipf * 1e-6);
+    printf("(%d hardware threads, %zu MB)\n", threads, megabytes);
+    return 0;
+}
@@ -0,0 +1,159 @@
+/**
+ * Benchmark: parallel LSD radix sort vs qsort vs std::sort
+ * Usage: sort_bench [maxCount]   (default 10M, e.g. 100000000 for 100M keys)
+ */
+#include "radix_sort.h"
+#include "ivector.h"
+#include "parallel.h"
+#include "timer.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cstdint>
+#include <algorithm>
+#include <vector>
+
+
+static uint64_t splitmix64(uint64_t& state)
+{
+    uint64_t z = (state += 0x9e3779b97f4a7c15ULL);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+}
+
+static int cmp_i32(const void* a, const void* b)
+{
+    int32_t x = *(const int32_t*)a, y = *(const int32_t*)b;
+    return (x > y) - (x < y);
+}
+static int cmp_u64(const void* a, const void* b)
+{
+    uint64_t x = *(const uint64_t*)a, y = *(const uint64_t*)b;
+    return (x > y) - (x < y);
+}
+
+
+// runs @sort on a fresh copy of @input a few times and returns the best time in seconds
+template<class T, class SortFn>
+static double time_sort(const std::vector<T>& input, const std::vector<T>& expected, SortFn sort)
+{
+    size_t count = input.size();
+    int reps = (int)std::min<size_t>(50, std::max<size_t>(1, 20000000 / count));
+    std::vector<T> work(count);
+    double best = 1e30;
+    for (int r = 0; r < reps; ++r)
+    {
+        memcpy(work.data(), input.data(), count * sizeof(T));
+        double start = timer_now();
+        sort(work.data(), count);
+        double elapsed = timer_now() - start;
+        if (elapsed < best) best = elapsed;
+    }
+    if (work != expected)
+    {
+        fprintf(stderr, "error: sort result mismatch at count=%zu\n", count);
+        exit(1);
+    }
+    return best;
+}
+
+
+static void report(const char* name, size_t count, double seconds, double baseline)
+{
+    printf("  %-18s %10.3f ms  %8.1f Mkeys/s  %6.2fx vs qsort\n",
+           name, seconds * 1e3, count / seconds * 1e-6, baseline / seconds);
+}
+
+
+template<class T>
+static std::vector<T> random_keys(size_t count, uint64_t seed)
+{
+    std::vector<T> keys(count);
+    for (size_t i = 0; i < count; ++i)
+        keys[i] = (T)splitmix64(seed);
+    return keys;
+}
+
+
+static void bench_i32(size_t count, int threads)
+{
+    printf("int32 x %zu\n", count);
+    std::vector<int32_t> input = random_keys<int32_t>(count, count);
+    std::vector<int32_t> expected = input;
+    std::sort(expected.begin(), expected.end());
+
+    double tq = time_sort(input, expected, [](int32_t* p, size_t n) { qsort(p, n, sizeof *p, cmp_i32); });
+    double ts = time_sort(input, expected, [](int32_t* p, size_t n) { std::sort(p, p + n); });
+    double t1 = time_sort(input, expected, [](int32_t* p, size_t n) { radix_sort_i32(p, n, 1); });
+    double tn = time_sort(input, expected, [threads](int32_t* p, size_t n) { radix_sort_i32(p, n, threads); });
+    report("qsort", count, tq, tq);
+    report("std::sort", count, ts, tq);
+    report("radix 1 thread", count, t1, tq);
+    char name[32];
+    snprintf(name, sizeof name, "radix %d threads", threads);
+    report(name, count, tn, tq);
+}
+
+
+static void bench_u64(size_t count, int threads)
+{
+    printf("uint64 x %zu\n", count);
+    std::vector<uint64_t> input = random_keys<uint64_t>(count, count + 1);
+    std::vector<uint64_t> expected = input;
+    std::sort(expected.begin(), expected.end());
+
+    double tq = time_sort(input, expected, [](uint64_t* p, size_t n) { qsort(p, n, sizeof *p, cmp_u64); });
+    double ts = time_sort(input, expected, [](uint64_t* p, size_t n) { std::sort(p, p + n); });
+    double tn = time_sort(input, expected, [threads](uint64_t* p, size_t n) { radix_sort_u64(p, n, threads); });
+    report("qsort", count, tq, tq);
+    report("std::sort", count, ts, tq);
+    char name[32];
+    snprintf(name, sizeof name, "radix %d threads", threads);
+    report(name, count, tn, tq);
+}
+
+
+// sort + unique + intersect on ivectors, the typical post-processing pipeline
+static void bench_ivector(size_t count)
+{
+    uint64_t seed = 12345;
+    ivector* a = iv_new();
+    ivector* b = iv_new();
+    for (size_t i = 0; i < count; ++i) iv_add(a, (int)(splitmix64(seed) % (count * 2)));
+    for (size_t i = 0; i < count; ++i) iv_add(b, (int)(splitmix64(seed) % (count * 2)));
+
+    double start = timer_now();
+    iv_sort(a); iv_unique(a);
+    iv_sort(b); iv_unique(b);
+    double sorted = timer_now();
+    ivector* c = iv_intersect(a, b);
+    double done = timer_now();
+
+    int hits = 0;
+    for (int i = 0; i < c->size; ++i)
+        hits += iv_contains(a, c->data[i]) && iv_contains(b, c->data[i]);
+    if (hits != c->size)
+    {
+        fprintf(stderr, "error: iv_intersect returned items not present in both inputs\n");
+        exit(1);
+    }
+
+    printf("ivector x %zu: sort+unique %.3f ms, intersect %.3f ms (%d common)\n",
+           count, (sorted - start) * 1e3, (done - sorted) * 1e3, c->size);
+    iv_free(a); iv_free(b); iv_free(c);
+}
+
+
+int main(int argc, char** argv)
+{
+    size_t maxCount = argc > 1 ? strtoull(argv[1], NULL, 10) : 10000000;
+    int threads = parallel_hw_threads();
+
+    for (size_t count = 1000; count <= maxCount; count *= 10)
+        bench_i32(count, threads);
+    for (size_t count = 1000; count <= maxCount; count *= 10)
+        bench_u64(count, threads);
+    bench_ivector(maxCount < 1000000 ? maxCount : 1000000);
+    return 0;
+}
@@ -0,0 +1,209 @@
+/**
+ * Benchmark: my_strcpy1/2/3 vs libc vs the string kernels of every CPU level
+ * Checks every kernel for correctness (all alignments, strings ending right before
+ * an unmapped page) and reports GB/s for string lengths from 1B to 1MB
+ */
+#include "mystring.h"
+#include "kernels.h"
+#include "timer.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <string>
+#include <vector>
+
+#if !_WIN32
+    #include <sys/mman.h> // mmap, mprotect
+    #include <unistd.h>   // sysconf
+#endif
+
+
+typedef std::function<void(char* dst, const char* src)> copy_fn;
+typedef std::function<size_t(const char* s)> len_fn;
+
+struct copy_kernel { std::string name; copy_fn fn; };
+struct len_kernel  { std::string name; len_fn fn; };
+
+static std::vector<copy_kernel> copies;
+static std::vector<len_kernel> lengths;
+static std::vector<const kernel_table*> levels; // every level this CPU supports
+
+// the course examples and libc, then the kernels of every supported level
+static void add_kernels()
+{
+    copies.push_back({ "my_strcpy1", my_strcpy1 });
+    copies.push_back({ "my_strcpy2", my_strcpy2 });
+    copies.push_back({ "my_strcpy3", my_strcpy3 });
+    copies.push_back({ "libc strcpy", [](char* d, const char* s) { strcpy(d, s); } });
+    lengths.push_back({ "libc strlen", [](const char* s) { return strlen(s); } });
+
+    for (int level = CPU_SCALAR; level < CPU_LEVEL_COUNT; ++level)
+    {
+        const kernel_table* t = kernels_for_level((cpu_level)level);
+        if (!t) break;
+        levels.push_back(t);
+        std::string name = cpu_level_name(t->level);
+        copies.push_back({ "str_copy " + name, [t](char* d, const char* s) { t->str_copy(d, s); } });
+        lengths.push_back({ "str_nlen " + name, [t](const char* s) { return t->str_nlen(s, (size_t)-1); } });
+    }
+}
+
+
+static int failures = 0;
+static void fail(const char* name, const char* what, size_t len, size_t srcAlign, size_t dstAlign)
+{
+    if (++failures <= 10)
+        fprintf(stderr, "FAIL %s: %s (len=%zu srcAlign=%zu dstAlign=%zu)\n", name, what, len, srcAlign, dstAlign);
+}
+
+
+// every kernel against every src/dst alignment for short and medium strings
+static void check_alignments()
+{
+    std::vector<char> src(4096 + 64), dst(4096 + 64);
+    for (size_t len = 0; len <= 300; len += (len < 40 ? 1 : 37))
+    for (size_t sa = 0; sa < 16; ++sa)
+    for (size_t da = 0; da < 16; ++da)
+    {
+        char* s = src.data() + sa;
+        memset(src.data(), 'x', src.size()); // no stray zeros after the terminator
+        for (size_t i = 0; i < len; ++i) s[i] = (char)('a' + i % 26);
+        s[len] = 0;
+
+        for (size_t k = 0; k < lengths.size(); ++k)
+            if (lengths[k].fn(s) != len)
+                fail(lengths[k].name.c_str(), "wrong length", len, sa, 0);
+
+        for (size_t k = 0; k < copies.size(); ++k)
+        {
+            char* d = dst.data() + da;
+            memset(dst.data(), '#', dst.size());
+            copies[k].fn(d, s);
+            if (memcmp(d, s, len + 1) != 0)
+                fail(copies[k].name.c_str(), "wrong copy", len, sa, da);
+            if (d[len + 1] != '#')
+                fail(copies[k].name.c_str(), "wrote past the terminator", len, sa, da);
+        }
+
+        // bounded length and copy truncation
+        for (size_t size = 0; size <= len + 2 && size < 40; ++size)
+        {
+            size_t expect = size == 0 ? 0 : (len < size - 1 ? len : size - 1);
+            for (const kernel_table* t : levels)
+                if (t->str_nlen(s, size) != (len < size ? len : size))
+                    fail(cpu_level_name(t->level), "str_nlen limit", len, sa, size);
+
+            char* d = dst.data() + da;
+            memset(dst.data(), '#', dst.size());
+            bool ok = my_strlcpy(d, s, size) == len && // strlen(src), even when truncated
+                      (size == 0 ? d[0] == '#' : (memcmp(d, s, expect) == 0 && d[expect] == 0 && d[expect + 1] == '#'));
+            if (!ok) fail("my_strlcpy", "wrong truncation", len, sa, da);
+        }
+    }
+}
+
+
+// strings whose terminator is the very last byte before an unmapped page:
+// any kernel that reads across the page boundary crashes here
+static void check_page_boundary()
+{
+#if !_WIN32
+    size_t page = (size_t)sysconf(_SC_PAGESIZE);
+    char* mem = (char*)mmap(NULL, page * 2, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (mem == MAP_FAILED || mprotect(mem + page, page, PROT_NONE) != 0)
+    {
+        printf("page boundary check skipped (mmap/mprotect failed)\n");
+        return;
+    }
+    std::vector<char> dst(page + 16);
+    for (size_t len = 0; len < 100; ++len)
+    {
+        char* s = mem + page - 1 - len;
+        memset(s, 'p', len);
+        s[len] = 0;
+        for (size_t k = 0; k < lengths.size(); ++k)
+            if (lengths[k].fn(s) != len)
+                fail(lengths[k].name.c_str(), "wrong length at page end", len, (size_t)s & 15, 0);
+        for (size_t k = 0; k < copies.size(); ++k)
+        {
+            copies[k].fn(dst.data(), s);
+            if (memcmp(dst.data(), s, len + 1) != 0)
+                fail(copies[k].name.c_str(), "wrong copy at page end", len, (size_t)s & 15, 0);
+        }
+    }
+    munmap(mem, page * 2);
+#endif
+}
+
+
+// runs @fn enough times to process ~64MB and returns GB/s
+template<class Fn>
+static double measure(size_t len, Fn fn)
+{
+    size_t bytes = len + 1;
+    size_t reps = (64u << 20) / bytes;
+    if (reps < 3) reps = 3;
+    double start = timer_now();
+    for (size_t r = 0; r < reps; ++r)
+        fn();
+    double elapsed = timer_now() - start;
+    return (double)bytes * reps / elapsed * 1e-9;
+}
+
+
+static volatile size_t sink; // keeps strlen results alive
+
+int main(int argc, char** argv)
+{
+    add_kernels();
+    check_alignments();
+    check_page_boundary();
+    if (failures)
+    {
+        fprintf(stderr, "%d correctness failures\n", failures);
+        return 1;
+    }
+    printf("all string kernels passed correctness checks\n\n");
+
+    const size_t maxLen = 1 << 20;
+    std::vector<char> srcBuf(maxLen + 64), dstBuf(maxLen + 64);
+    char* src = srcBuf.data() + 1; // deliberately misaligned by one byte
+    char* dst = dstBuf.data() + 3;
+
+    printf("%-16s", "GB/s");
+    for (size_t len = 1; len <= maxLen; len *= 4)
+    {
+        if (len < 1024) printf("%8zuB", len);
+        else            printf("%7zuKB", len / 1024);
+    }
+    printf("\n");
+
+    for (size_t k = 0; k < copies.size(); ++k)
+    {
+        printf("%-16s", copies[k].name.c_str());
+        for (size_t len = 1; len <= maxLen; len *= 4)
+        {
+            memset(src, 'a', len);
+            src[len] = 0;
+            copy_fn fn = copies[k].fn;
+            printf("%9.2f", measure(len, [&] { fn(dst, src); }));
+            fflush(stdout);
+        }
+        printf("\n");
+    }
+    for (size_t k = 0; k < lengths.size(); ++k)
+    {
+        printf("%-16s", lengths[k].name.c_str());
+        for (size_t len = 1; len <= maxLen; len *= 4)
+        {
+            memset(src, 'a', len);
+            src[len] = 0;
+            len_fn fn = lengths[k].fn;
+            printf("%9.2f", measure(len, [&] { sink = fn(src); }));
+            fflush(stdout);
+        }
+        printf("\n");
+    }
+    return 0;
+}
@@ -0,0 +1,239 @@
+/**
+ * Benchmark: vec2batch SoA kernels vs plain AoS loops over vector2 arrays
+ * Working sets are sized to fit L1, L2 or only DRAM; results are checked against AoS
+ */
+#include "vec2batch.h"
+#include "timer.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+
+// the AoS baselines: one vector2 at a time, the way printVectors() walks vectorArray
+static void aos_add(vector2* out, const vector2* a, const vector2* b, int n)
+{
+    for (int i = 0; i < n; ++i) { out[i].x = a[i].x + b[i].x; out[i].y = a[i].y + b[i].y; }
+}
+static void aos_scale(vector2* out, const vector2* a, int s, int n)
+{
+    for (int i = 0; i < n; ++i) { out[i].x = a[i].x * s; out[i].y = a[i].y * s; }
+}
+static void aos_dot(int* out, const vector2* a, const vector2* b, int n)
+{
+    for (int i = 0; i < n; ++i) out[i] = a[i].x * b[i].x + a[i].y * b[i].y;
+}
+static void aos_bounds(const vector2* a, int n, vector2* lo, vector2* hi)
+{
+    *lo = *hi = a[0];
+    for (int i = 1; i < n; ++i)
+    {
+        if (a[i].x < lo->x) lo->x = a[i].x;
+        if (a[i].x > hi->x) hi->x = a[i].x;
+        if (a[i].y < lo->y) lo->y = a[i].y;
+        if (a[i].y > hi->y) hi->y = a[i].y;
+    }
+}
+static void aos_transform(vector2* out, const vector2* a, const int m[4], int n)
+{
+    for (int i = 0; i < n; ++i)
+    {
+        int x = a[i].x, y = a[i].y;
+        out[i].x = m[0] * x + m[1] * y;
+        out[i].y = m[2] * x + m[3] * y;
+    }
+}
+
+static void aosf_add(vector2f* out, const vector2f* a, const vector2f* b, int n)
+{
+    for (int i = 0; i < n; ++i) { out[i].x = a[i].x + b[i].x; out[i].y = a[i].y + b[i].y; }
+}
+static void aosf_scale(vector2f* out, const vector2f* a, float s, int n)
+{
+    for (int i = 0; i < n; ++i) { out[i].x = a[i].x * s; out[i].y = a[i].y * s; }
+}
+static void aosf_dot(float* out, const vector2f* a, const vector2f* b, int n)
+{
+    for (int i = 0; i < n; ++i) out[i] = a[i].x * b[i].x + a[i].y * b[i].y;
+}
+static void aosf_bounds(const vector2f* a, int n, vector2f* lo, vector2f* hi)
+{
+    *lo = *hi = a[0];
+    for (int i = 1; i < n; ++i)
+    {
+        if (a[i].x < lo->x) lo->x = a[i].x;
+        if (a[i].x > hi->x) hi->x = a[i].x;
+        if (a[i].y < lo->y) lo->y = a[i].y;
+        if (a[i].y > hi->y) hi->y = a[i].y;
+    }
+}
+static void aosf_transform(vector2f* out, const vector2f* a, const float m[4], int n)
+{
+    for (int i = 0; i < n; ++i)
+    {
+        float x = a[i].x, y = a[i].y;
+        out[i].x = m[0] * x + m[1] * y;
+        out[i].y = m[2] * x + m[3] * y;
+    }
+}
+
+
+// repeats @fn until ~50M points were processed, returns ns per point
+template<class Fn>
+static double ns_per_point(int n, Fn fn)
+{
+    int reps = 50000000 / n;
+    if (reps < 3) reps = 3;
+    fn(); // warm up caches
+    double start = timer_now();
+    for (int r = 0; r < reps; ++r)
+        fn();
+    return (timer_now() - start) / ((double)reps * n) * 1e9;
+}
+
+
+static int failures = 0;
+static void check(bool ok, const char* what, int n)
+{
+    if (!ok && ++failures <= 10)
+        fprintf(stderr, "FAIL %s at n=%d\n", what, n);
+}
+
+
+static void row(const char* op, double aos, double soa)
+{
+    printf("  %-12s %8.3f ns %8.3f ns %7.2fx\n", op, aos, soa, aos / soa);
+}
+
+
+static void bench_int(int n)
+{
+    std::vector<vector2> a(n), b(n), out(n), back(n);
+    for (int i = 0; i < n; ++i)
+    {
+        a[i].x = rand() % 2000 - 1000; a[i].y = rand() % 2000 - 1000;
+        b[i].x = rand() % 2000 - 1000; b[i].y = rand() % 2000 - 1000;
+    }
+    vec2i_soa* sa = v2i_new(0);
+    vec2i_soa* sb = v2i_new(0);
+    vec2i_soa* so = v2i_new(0);
+    v2i_from_aos(sa, a.data(), n);
+    v2i_from_aos(sb, b.data(), n);
+    std::vector<int> dotA(n), dotS(n);
+    const int m[4] = { 3, -2, 5, 7 };
+
+    // correctness first
+    v2i_to_aos(back.data(), sa);
+    check(memcmp(back.data(), a.data(), sizeof(vector2) * n) == 0, "int AoS<->SoA round trip", n);
+    aos_add(out.data(), a.data(), b.data(), n); v2i_add(so, sa, sb); v2i_to_aos(back.data(), so);
+    check(memcmp(back.data(), out.data(), sizeof(vector2) * n) == 0, "v2i_add", n);
+    aos_scale(out.data(), a.data(), 7, n); v2i_scale(so, sa, 7); v2i_to_aos(back.data(), so);
+    check(memcmp(back.data(), out.data(), sizeof(vector2) * n) == 0, "v2i_scale", n);
+    aos_transform(out.data(), a.data(), m, n); v2i_transform(so, sa, m); v2i_to_aos(back.data(), so);
+    check(memcmp(back.data(), out.data(), sizeof(vector2) * n) == 0, "v2i_transform", n);
+    aos_dot(dotA.data(), a.data(), b.data(), n); v2i_dot(dotS.data(), sa, sb);
+    check(dotA == dotS, "v2i_dot", n);
+    aos_dot(dotA.data(), a.data(), a.data(), n); v2i_length2(dotS.data(), sa);
+    check(dotA == dotS, "v2i_length2", n);
+    vector2 lo1, hi1, lo2, hi2;
+    aos_bounds(a.data(), n, &lo1, &hi1); v2i_bounds(sa, &lo2, &hi2);
+    check(lo1.x == lo2.x && lo1.y == lo2.y && hi1.x == hi2.x && hi1.y == hi2.y, "v2i_bounds", n);
+
+    row("add",       ns_per_point(n, [&] { aos_add(out.data(), a.data(), b.data(), n); }),
+                     ns_per_point(n, [&] { v2i_add(so, sa, sb); }));
+    row("scale",     ns_per_point(n, [&] { aos_scale(out.data(), a.data(), 7, n); }),
+                     ns_per_point(n, [&] { v2i_scale(so, sa, 7); }));
+    row("dot",       ns_per_point(n, [&] { aos_dot(dotA.data(), a.data(), b.data(), n); }),
+                     ns_per_point(n, [&] { v2i_dot(dotS.data(), sa, sb); }));
+    row("length2",   ns_per_point(n, [&] { aos_dot(dotA.data(), a.data(), a.data(), n); }),
+                     ns_per_point(n, [&] { v2i_length2(dotS.data(), sa); }));
+    row("bounds",    ns_per_point(n, [&] { aos_bounds(a.data(), n, &lo1, &hi1); }),
+                     ns_per_point(n, [&] { v2i_bounds(sa, &lo2, &hi2); }));
+    row("transform", ns_per_point(n, [&] { aos_transform(out.data(), a.data(), m, n); }),
+                     ns_per_point(n, [&] { v2i_transform(so, sa, m); }));
+
+    v2i_free(sa); v2i_free(sb); v2i_free(so);
+}
+
+
+static void bench_float(int n)
+{
+    std::vector<vector2f> a(n), b(n), out(n), back(n);
+    for (int i = 0; i < n; ++i)
+    {
+        a[i].x = rand() / (float)RAND_MAX - 0.5f; a[i].y = rand() / (float)RAND_MAX - 0.5f;
+        b[i].x = rand() / (float)RAND_MAX - 0.5f; b[i].y = rand() / (float)RAND_MAX - 0.5f;
+    }
+    vec2f_soa* sa = v2f_new(0);
+    vec2f_soa* sb = v2f_new(0);
+    vec2f_soa* so = v2f_new(0);
+    v2f_from_aos(sa, a.data(), n);
+    v2f_from_aos(sb, b.data(), n);
+    std::vector<float> dotA(n), dotS(n);
+    const float m[4] = { 0.5f, -0.866f, 0.866f, 0.5f }; // 60 degree rotation
+
+    v2f_to_aos(back.data(), sa);
+    check(memcmp(back.data(), a.data(), sizeof(vector2f) * n) == 0, "float AoS<->SoA round trip", n);
+    aosf_add(out.data(), a.data(), b.data(), n); v2f_add(so, sa, sb); v2f_to_aos(back.data(), so);
+    check(memcmp(back.data(), out.data(), sizeof(vector2f) * n) == 0, "v2f_add", n);
+    aosf_scale(out.data(), a.data(), 1.5f, n); v2f_scale(so, sa, 1.5f); v2f_to_aos(back.data(), so);
+    check(memcmp(back.data(), out.data(), sizeof(vector2f) * n) == 0, "v2f_scale", n);
+    aosf_transform(out.data(), a.data(), m, n); v2f_transform(so, sa, m); v2f_to_aos(back.data(), so);
+    check(memcmp(back.data(), out.data(), sizeof(vector2f) * n) == 0, "v2f_transform", n);
+    aosf_dot(dotA.data(), a.data(), b.data(), n); v2f_dot(dotS.data(), sa, sb);
+    check(dotA == dotS, "v2f_dot", n);
+    vector2f lo1, hi1, lo2, hi2;
+    aosf_bounds(a.data(), n, &lo1, &hi1); v2f_bounds(sa, &lo2, &hi2);
+    check(lo1.x == lo2.x && lo1.y == lo2.y && hi1.x == hi2.x && hi1.y == hi2.y, "v2f_bounds", n);
+
+    row("add",       ns_per_point(n, [&] { aosf_add(out.data(), a.data(), b.data(), n); }),
+                     ns_per_point(n, [&] { v2f_add(so, sa, sb); }));
+    row("scale",     ns_per_point(n, [&] { aosf_scale(out.data(), a.data(), 1.5f, n); }),
+                     ns_per_point(n, [&] { v2f_scale(so, sa, 1.5f); }));
+    row("dot",       ns_per_point(n, [&] { aosf_dot(dotA.data(), a.data(), b.data(), n); }),
+                     ns_per_point(n, [&] { v2f_dot(dotS.data(), sa, sb); }));
+    row("length2",   ns_per_point(n, [&] { aosf_dot(dotA.data(), a.data(), a.data(), n); }),
+                     ns_per_point(n, [&] { v2f_length2(dotS.data(), sa); }));
+    row("bounds",    ns_per_point(n, [&] { aosf_bounds(a.data(), n, &lo1, &hi1); }),
+                     ns_per_point(n, [&] { v2f_bounds(sa, &lo2, &hi2); }));
+    row("transform", ns_per_point(n, [&] { aosf_transform(out.data(), a.data(), m, n); }),
+                     ns_per_point(n, [&] { v2f_transform(so, sa, m); }));
+
+    v2f_free(sa); v2f_free(sb); v2f_free(so);
+}
+
+
+int main()
+{
+    // a, b and out at 8 bytes per point each: 24 bytes of working set per point
+    struct { const char* name; int points; } sizes[] = {
+        { "L1   (~24KB)", 1000 },
+        { "L2   (~384KB)", 16000 },
+        { "DRAM (~96MB)", 4000000 },
+    };
+    for (auto& size : sizes)
+    {
+        printf("int   %-14s %d points    AoS loop    SoA SIMD   speedup\n", size.name, size.points);
+        bench_int(size.points);
+        printf("float %-14s %d points    AoS loop    SoA SIMD   speedup\n", size.name, size.points);
+        bench_float(size.points);
+    }
+    // odd sizes exercise the scalar tails
+    for (int n = 1; n < 12; ++n)
+    {
+        std::vector<vector2> a(n);
+        vec2i_soa* s = v2i_new(0);
+        for (int i = 0; i < n; ++i) { a[i].x = i; a[i].y = -i; }
+        v2i_from_aos(s, a.data(), n);
+        vector2 lo, hi;
+        v2i_bounds(s, &lo, &hi);
+        check(lo.x == 0 && hi.x == n - 1 && lo.y == -(n - 1) && hi.y == 0, "v2i_bounds tail", n);
+        v2i_free(s);
+    }
+    if (failures)
+    {
+        fprintf(stderr, "%d correctness failures\n", failures);
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,168 @@
+/**
+ * civector - a concurrent append-only integer vector
+ * Uses C99 dialect, so compile with -std=gnu99 or -std=c99
+ */
+#include "civector.h"
+#include "atomics.h" // atomic_fetch_add_int, atomic_cas_ptr, ...
+#include "bitops.h"  // bit_log2_32
+#include <stdlib.h>  // malloc, calloc, free
+#include <string.h>  // memcpy, memchr
+
+
+static int segment_size(int segment)
+{
+    return CIV_FIRST_SEGMENT << segment;
+}
+
+
+// maps an item index to its segment and the offset inside that segment
+static int locate(int index, int* offset)
+{
+    unsigned v = (unsigned)index + CIV_FIRST_SEGMENT;
+    int bit = bit_log2_32(v);
+    *offset = (int)(v - (1u << bit));
+    return bit - CIV_SEGMENT_BITS;
+}
+
+
+static unsigned char* ready_flags(int* items, int segment)
+{
+    return (unsigned char*)(items + segment_size(segment));
+}
+
+
+// the first writer to touch a segment allocates it; if two writers race,
+// the loser frees its copy and uses the winner's; NULL if out of memory
+static int* get_segment(civector* civ, int segment)
+{
+    int* items = atomic_load_ptr(&civ->segments[segment]);
+    if (items)
+        return items;
+
+    size_t n = segment_size(segment);
+    int* fresh = calloc(1, n * sizeof(int) + n); // items + zeroed ready flags
+    if (!fresh) // leave the segment empty, a later writer may still get the memory
+        return NULL;
+    items = atomic_cas_ptr(&civ->segments[segment], NULL, fresh);
+    if (items) // somebody else was faster
+    {
+        free(fresh);
+        return items;
+    }
+    return fresh;
+}
+
+
+
+civector* civ_new()
+{
+    civector* civ = calloc(1, sizeof(civector)); // size = published = 0, no segments
+    return civ;
+}
+
+
+void civ_free(civector* civ)
+{
+    if (civ)
+    {
+        for (int s = 0; s < CIV_MAX_SEGMENTS; ++s)
+            free(civ->segments[s]);
+        free(civ);
+    }
+}
+
+
+int civ_add(civector* civ, int item)
+{
+    int index = atomic_fetch_add_int(&civ->size, 1); // reserve a slot, never blocks
+    if (index >= CIV_MAX_ITEMS)
+    {
+        atomic_fetch_add_int(&civ->size, -1); // full: give the slot back so @size stays bounded
+        return -1;
+    }
+    int offset;
+    int segment = locate(index, &offset);
+    int* items  = get_segment(civ, segment);
+    if (!items)
+        return -1; // the slot stays unwritten, so civ_published() stops before it
+
+    items[offset] = item;
+    atomic_store_u8(ready_flags(items, segment) + offset, 1); // publish (release)
+    return index;
+}
+
+
+int civ_published(civector* civ)
+{
+    int start    = atomic_load_int(&civ->published);
+    int reserved = atomic_load_int(&civ->size);
+    if (reserved > CIV_MAX_ITEMS)
+        reserved = CIV_MAX_ITEMS; // rejected appends that haven't given their slot back yet
+    int n = start;
+
+    // walk forward from the last known watermark until the first unwritten slot
+    while (n < reserved)
+    {
+        int offset;
+        int segment = locate(n, &offset);
+        int* items  = atomic_load_ptr(&civ->segments[segment]);
+        if (!items)
+            break;
+        const unsigned char* ready = ready_flags(items, segment);
+        int end = segment_size(segment);
+        if (end - offset > reserved - n)
+            end = offset + (reserved - n);
+        while (offset < end && atomic_load_u8(ready + offset))
+            ++offset, ++n;
+        if (offset < end)
+            break;
+    }
+
+    // advance the shared watermark so the next reader doesn't rescan,
+    // losing the race to a reader that saw further is fine
+    int current = start;
+    while (current < n)
+    {
+        int prev = atomic_cas_int(&civ->published, current, n);
+        if (prev == current)
+            break;
+        current = prev;
+    }
+    return n;
+}
+
+
+int civ_at(const civector* civ, int index)
+{
+    int offset;
+    int segment = locate(index, &offset);
+    return ((int*)civ->segments[segment])[offset];
+}
+
+
+ivector* civ_freeze(const civector* civ)
+{
+    int size = civ->size < CIV_MAX_ITEMS ? civ->size : CIV_MAX_ITEMS;
+    ivector* iv = iv_new();
+    iv_reserve(iv, size);
+
+    int copied = 0;
+    // segments are already in index order; after a failed civ_add() a slot or a whole
+    // segment is missing, then only the items before it are copied, like civ_published()
+    for (int s = 0; copied < size && civ->segments[s]; ++s)
+    {
+        int* items = civ->segments[s];
+        int n = segment_size(s);
+        if (n > size - copied)
+            n = size - copied;
+        const unsigned char* hole = memchr(ready_flags(items, s), 0, n);
+        if (hole)
+            n = (int)(hole - ready_flags(items, s));
+        memcpy(iv->data + copied, items, sizeof(int) * n);
+        copied += n;
+        if (hole)
+            break;
+    }
+    iv->size = copied;
+    return iv;
+}
@@ -0,0 +1,48 @@
+/**
+ * civector - a concurrent append-only integer vector
+ * Any number of threads can civ_add() at the same time without a lock:
+ * slots are reserved with an atomic fetch-add on @size, and the storage is a list
+ * of segments that double in size, so existing items are never moved or reallocated.
+ * Readers can walk the published prefix while writers keep appending, and
+ * civ_freeze() compacts everything into a regular contiguous ivector at the end.
+ */
+#pragma once
+#include "ivector.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+#define CIV_SEGMENT_BITS 10                      // first segment holds 1024 items
+#define CIV_FIRST_SEGMENT (1 << CIV_SEGMENT_BITS)// every next segment is twice as large
+#define CIV_MAX_SEGMENTS 20                      // 1024 * (2^20 - 1) items, about INT_MAX / 2
+#define CIV_MAX_ITEMS (CIV_FIRST_SEGMENT * ((1 << CIV_MAX_SEGMENTS) - 1))
+                                                 // the headroom up to INT_MAX keeps @size from
+                                                 // overflowing while rejected appends back out
+#define CIV_CACHE_LINE 64
+
+
+typedef struct _civector {
+    volatile int size;       // number of reserved slots, some may still be in flight
+    char pad0[CIV_CACHE_LINE - sizeof(int)];  // keep the hot counter on its own cache line
+    volatile int published;  // [0, published) are known to be written
+    char pad1[CIV_CACHE_LINE - sizeof(int)];
+    void* volatile segments[CIV_MAX_SEGMENTS]; // int items[n] followed by unsigned char ready[n]
+} civector;
+
+
+civector* civ_new();                       // allocates a new empty concurrent vector
+void civ_free(civector* civ);              // frees the vector, no writers may be active
+int  civ_add(civector* civ, int item);     // thread-safe append, returns the item's index,
+                                           // or -1 if the vector already holds CIV_MAX_ITEMS
+                                           // or a new segment can't be allocated
+int  civ_published(civector* civ);         // length of the prefix that is safe to read
+int  civ_at(const civector* civ, int index); // item at @index, only valid if index < civ_published()
+ivector* civ_freeze(const civector* civ);  // copies all items into a new contiguous ivector,
+                                           // call only after all writers have finished
+
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,156 @@
+/**
+ * ivector - an integer vector, a dynamic array that changes its size on demand
+ * Uses C99 dialect, so compile with -std=gnu99 or -std=c99
+ */
+#include "ivector.h"
+#include "radix_sort.h" // radix_sort_i32
+#include <stdlib.h>     // malloc, realloc, free
+#include <stdint.h>     // int32_t
+
+
+ivector* iv_new() // initializes an existing vector
+{
+    ivector* iv = malloc(sizeof(ivector));
+    iv->size     = 0;   // no elements yet
+    iv->capacity = 0;   // mark the initial capacity
+    iv->data     = NULL;// lazy init array data
+    return iv;
+}
+void iv_free(ivector* iv) // destroys the vector and frees any allocated data
+{
+    if (iv)
+    {
+        if (iv->data)
+            free(iv->data); // free array data
+        free(iv);           // destroy this object
+    }
+}
+void iv_add(ivector* iv, int item) // adds an item to the end of the vector
+{
+    if (iv->size == iv->capacity) // grow needed?
+    {
+        iv->capacity += 4 + iv->capacity / 2; // amortized increase
+        iv->data = realloc(iv->data, sizeof(int) * iv->capacity);
+    }
+    iv->data[iv->size++] = item; // append the item
+}
+void iv_reserve(ivector* iv, int capacity) // makes room for at least @capacity items
+{
+    if (capacity > iv->capacity)
+    {
+        iv->capacity = capacity;
+        iv->data = realloc(iv->data, sizeof(int) * iv->capacity);
+    }
+}
+
+
+
+void iv_sort(ivector* iv)
+{
+    radix_sort_i32((int32_t*)iv->data, iv->size, 0); // 0: use all hardware threads
+}
+
+
+int iv_unique(ivector* iv)
+{
+    if (iv->size < 2)
+        return iv->size;
+
+    int* data = iv->data;
+    int  last = 0; // index of the last unique item
+    for (int i = 1; i < iv->size; ++i)
+    {
+        if (data[i] != data[last])
+            data[++last] = data[i];
+    }
+    return iv->size = last + 1;
+}
+
+
+// branchless binary search: the loop always runs log2(n) times and the
+// comparison compiles to a cmov, so there are no mispredicted branches
+static int lower_bound(const int* data, int size, int value)
+{
+    if (size == 0)
+        return 0;
+    const int* base = data;
+    int n = size;
+    while (n > 1)
+    {
+        int half = n / 2;
+        base = (base[half] < value) ? base + half : base;
+        n -= half;
+    }
+    return (int)(base - data) + (*base < value);
+}
+
+
+int iv_lower_bound(const ivector* iv, int value)
+{
+    return lower_bound(iv->data, iv->size, value);
+}
+
+
+int iv_contains(const ivector* iv, int value)
+{
+    int i = lower_bound(iv->data, iv->size, value);
+    return i < iv->size && iv->data[i] == value;
+}
+
+
+// exponential search forward from @start: cheap when the answer is close by
+static int gallop(const int* data, int start, int size, int value)
+{
+    unsigned step = 1; // unsigned and clamped, so near INT_MAX items nothing overflows
+    int lo = start, hi = start;
+    while (hi < size && data[hi] < value)
+    {
+        lo = hi + 1;
+        hi = step < (unsigned)(size - hi) ? hi + (int)step : size;
+        step *= 2;
+    }
+    return lo + lower_bound(data + lo, hi - lo, value);
+}
+
+
+#define IV_GALLOP_RATIO 16 // size ratio where galloping beats a linear merge
+
+
+ivector* iv_intersect(const ivector* a, const ivector* b)
+{
+    if (a->size > b->size) // make @a the smaller one
+    {
+        const ivector* t = a; a = b; b = t;
+    }
+
+    ivector* result = iv_new();
+    iv_reserve(result, a->size);
+    int* out = result->data;
+    int  n   = 0;
+
+    const int* x = a->data;
+    const int* y = b->data;
+    int i = 0, j = 0;
+
+    if (a->size < b->size / IV_GALLOP_RATIO) // very uneven sizes: skip ahead in b (a->size * 16 could overflow)
+    {
+        for (; i < a->size && j < b->size; ++i)
+        {
+            j = gallop(y, j, b->size, x[i]);
+            if (j < b->size && y[j] == x[i])
+                out[n++] = y[j++];
+        }
+    }
+    else // similar sizes: linear merge
+    {
+        while (i < a->size && j < b->size)
+        {
+            if      (x[i] < y[j]) ++i;
+            else if (y[j] < x[i]) ++j;
+            else { out[n++] = x[i]; ++i, ++j; }
+        }
+    }
+
+    result->size = n;
+    return result;
+}
@@ -0,0 +1,35 @@
+/**
+ * ivector - an integer vector, a dynamic array that changes its size on demand
+ * Used in Part 7 of pointers.c as an example of object-oriented C
+ */
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+typedef struct _ivector { // an integer vector - a dynamic array
+    int  size;            // that changes its size on demand
+    int  capacity;
+    int* data;
+} ivector;
+
+
+ivector* iv_new();                            // allocates a new empty vector
+void iv_free(ivector* iv);                    // destroys the vector and frees any allocated data
+void iv_add(ivector* iv, int item);           // adds an item to the end of the vector
+void iv_reserve(ivector* iv, int capacity);   // makes room for at least @capacity items
+
+
+// operations on sorted vectors:
+void iv_sort(ivector* iv);                    // sorts ascending (parallel radix sort)
+int  iv_unique(ivector* iv);                  // removes adjacent duplicates in-place, returns new size
+int  iv_lower_bound(const ivector* iv, int value); // index of the first item >= value, or size
+int  iv_contains(const ivector* iv, int value);    // 1 if the sorted vector contains value
+ivector* iv_intersect(const ivector* a, const ivector* b); // new sorted vector of items in both a and b
+
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,253 @@
+/**
+ * matrix - a 2D float matrix in one contiguous allocation
+ * Uses C99 dialect, so compile with -std=gnu99 or -std=c99
+ */
+#include "matrix.h"
+#include "aligned_mem.h" // mem_aligned_alloc, MEM_ALIGNMENT
+#include "parallel.h"    // parallel_run, parallel_chunk
+#include "simd.h"        // SIMD_SSE2
+
+#if SIMD_SSE2
+    #include <xmmintrin.h> // _MM_TRANSPOSE4_PS
+#endif
+
+
+#define MAT_ALIGN_FLOATS (MEM_ALIGNMENT / sizeof(float)) // 16 floats per cache line
+#define MAT_TRANSPOSE_TILE 32  // 32x32 floats = 4KB source + 4KB destination, fits L1
+#define MAT_BLOCK_ROWS 64      // 64x256 block of C = 64KB
+#define MAT_BLOCK_K    256     // 256x256 panel of B = 256KB, stays in L2
+#define MAT_BLOCK_COLS 256
+
+
+static inline int min_int(int a, int b) { return a < b ? a : b; }
+
+
+
+matrix mat_new(int rows, int cols)
+{
+    matrix m;
+    int stride = (int)((cols + MAT_ALIGN_FLOATS - 1) & ~(MAT_ALIGN_FLOATS - 1));
+    // with a power-of-2 stride of 1KB or more, the rows of a column map to only a few
+    // cache sets, so walking down a column thrashes; one extra cache line breaks that
+    if (stride % 256 == 0)
+        stride += MAT_ALIGN_FLOATS;
+
+    m.rows   = rows;
+    m.cols   = cols;
+    m.stride = stride;
+    m.owned  = mem_aligned_alloc(sizeof(float) * (size_t)rows * stride, MEM_ALIGNMENT);
+    m.data   = m.owned;
+    return m;
+}
+
+
+void mat_free(matrix* m)
+{
+    if (m->owned)
+        mem_aligned_free(m->owned);
+    m->owned = NULL;
+    m->data  = NULL;
+}
+
+
+matrix mat_view(const matrix* m, int row, int col, int rows, int cols)
+{
+    matrix v;
+    v.data   = mat_at(m, row, col);
+    v.rows   = rows;
+    v.cols   = cols;
+    v.stride = m->stride; // same memory, same distance between rows
+    v.owned  = NULL;
+    return v;
+}
+
+
+void mat_fill(matrix* m, float value)
+{
+    for (int i = 0; i < m->rows; ++i)
+    {
+        float* row = mat_row(m, i);
+        for (int j = 0; j < m->cols; ++j)
+            row[j] = value;
+    }
+}
+
+
+
+
+
+
+/**
+ * Transpose
+ */
+void mat_transpose_naive(matrix* dst, const matrix* src)
+{
+    for (int i = 0; i < src->rows; ++i)
+    {
+        const float* row = mat_row(src, i);
+        for (int j = 0; j < src->cols; ++j)
+            *mat_at(dst, j, i) = row[j]; // every write lands on a different cache line
+    }
+}
+
+
+// transposes the tiles in src rows [rowBegin, rowEnd)
+static void transpose_rows(matrix* dst, const matrix* src, int rowBegin, int rowEnd)
+{
+    for (int ii = rowBegin; ii < rowEnd; ii += MAT_TRANSPOSE_TILE)
+    for (int jj = 0; jj < src->cols; jj += MAT_TRANSPOSE_TILE)
+    {
+        int iend = min_int(ii + MAT_TRANSPOSE_TILE, rowEnd);
+        int jend = min_int(jj + MAT_TRANSPOSE_TILE, src->cols);
+        int i = ii;
+    #if SIMD_SSE2
+        for (; i + 4 <= iend; i += 4) // 4x4 blocks in registers
+        {
+            int j = jj;
+            for (; j + 4 <= jend; j += 4)
+            {
+                __m128 r0 = _mm_loadu_ps(mat_at(src, i + 0, j));
+                __m128 r1 = _mm_loadu_ps(mat_at(src, i + 1, j));
+                __m128 r2 = _mm_loadu_ps(mat_at(src, i + 2, j));
+                __m128 r3 = _mm_loadu_ps(mat_at(src, i + 3, j));
+                _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+                _mm_storeu_ps(mat_at(dst, j + 0, i), r0);
+                _mm_storeu_ps(mat_at(dst, j + 1, i), r1);
+                _mm_storeu_ps(mat_at(dst, j + 2, i), r2);
+                _mm_storeu_ps(mat_at(dst, j + 3, i), r3);
+            }
+            for (; j < jend; ++j) // leftover columns
+                for (int k = 0; k < 4; ++k)
+                    *mat_at(dst, j, i + k) = *mat_at(src, i + k, j);
+        }
+    #endif
+        for (; i < iend; ++i) // leftover rows
+            for (int j = jj; j < jend; ++j)
+                *mat_at(dst, j, i) = *mat_at(src, i, j);
+    }
+}
+
+
+typedef struct _mat_job {
+    matrix*       dst;
+    const matrix* a;
+    const matrix* b;
+    int           blockRows; // work is split in whole blocks of this many rows
+} mat_job;
+
+
+static void transpose_task(void* arg, int threadIdx, int numThreads)
+{
+    mat_job* job = arg;
+    int rows   = job->a->rows;
+    int blocks = (rows + job->blockRows - 1) / job->blockRows;
+    size_t begin, end;
+    parallel_chunk(blocks, threadIdx, numThreads, &begin, &end);
+    transpose_rows(job->dst, job->a, (int)begin * job->blockRows,
+                   min_int((int)end * job->blockRows, rows));
+}
+
+
+void mat_transpose(matrix* dst, const matrix* src, int numThreads)
+{
+    mat_job job = { dst, src, NULL, MAT_TRANSPOSE_TILE };
+    parallel_run(numThreads, transpose_task, &job);
+}
+
+
+
+
+
+
+/**
+ * Multiply
+ */
+void mat_multiply_naive(matrix* c, const matrix* a, const matrix* b)
+{
+    for (int i = 0; i < a->rows; ++i)
+    for (int j = 0; j < b->cols; ++j)
+    {
+        float sum = 0.0f;
+        for (int k = 0; k < a->cols; ++k)
+            sum += *mat_at(a, i, k) * *mat_at(b, k, j); // b is walked down a column
+        *mat_at(c, i, j) = sum;
+    }
+}
+
+
+// c[j] += a0*b0[j] + a1*b1[j] + a2*b2[j] + a3*b3[j]: four rows of B per pass over c
+static void madd4(float* c, const float* b0, const float* b1, const float* b2, const float* b3,
+                  float a0, float a1, float a2, float a3, int n)
+{
+    int j = 0;
+#if SIMD_SSE2
+    __m128 va0 = _mm_set1_ps(a0), va1 = _mm_set1_ps(a1);
+    __m128 va2 = _mm_set1_ps(a2), va3 = _mm_set1_ps(a3);
+    for (; j + 4 <= n; j += 4)
+    {
+        __m128 s01 = _mm_add_ps(_mm_mul_ps(va0, _mm_loadu_ps(b0 + j)), _mm_mul_ps(va1, _mm_loadu_ps(b1 + j)));
+        __m128 s23 = _mm_add_ps(_mm_mul_ps(va2, _mm_loadu_ps(b2 + j)), _mm_mul_ps(va3, _mm_loadu_ps(b3 + j)));
+        _mm_storeu_ps(c + j, _mm_add_ps(_mm_loadu_ps(c + j), _mm_add_ps(s01, s23)));
+    }
+#endif
+    for (; j < n; ++j)
+        c[j] += (a0 * b0[j] + a1 * b1[j]) + (a2 * b2[j] + a3 * b3[j]);
+}
+
+
+// computes rows [rowBegin, rowEnd) of C: a block of rows at a time, and within it
+// one L2-sized panel of B at a time, so the C block and the B panel both stay cached
+static void multiply_rows(matrix* c, const matrix* a, const matrix* b, int rowBegin, int rowEnd)
+{
+    int n = b->cols, depth = a->cols;
+    for (int i = rowBegin; i < rowEnd; ++i)
+    {
+        float* crow = mat_row(c, i);
+        for (int j = 0; j < n; ++j)
+            crow[j] = 0.0f;
+    }
+
+    for (int ii = rowBegin; ii < rowEnd; ii += MAT_BLOCK_ROWS)
+    for (int kk = 0; kk < depth; kk += MAT_BLOCK_K)
+    for (int jj = 0; jj < n; jj += MAT_BLOCK_COLS)
+    {
+        int iend  = min_int(ii + MAT_BLOCK_ROWS, rowEnd);
+        int kend  = min_int(kk + MAT_BLOCK_K, depth);
+        int width = min_int(jj + MAT_BLOCK_COLS, n) - jj;
+        for (int i = ii; i < iend; ++i)
+        {
+            float* crow = mat_row(c, i) + jj;
+            const float* arow = mat_row(a, i);
+            int k = kk;
+            for (; k + 4 <= kend; k += 4)
+                madd4(crow, mat_at(b, k, jj), mat_at(b, k + 1, jj), mat_at(b, k + 2, jj), mat_at(b, k + 3, jj),
+                      arow[k], arow[k + 1], arow[k + 2], arow[k + 3], width);
+            for (; k < kend; ++k)
+            {
+                const float* brow = mat_at(b, k, jj);
+                float aik = arow[k];
+                for (int j = 0; j < width; ++j)
+                    crow[j] += aik * brow[j];
+            }
+        }
+    }
+}
+
+
+static void multiply_task(void* arg, int threadIdx, int numThreads)
+{
+    mat_job* job = arg;
+    int rows   = job->a->rows;
+    int blocks = (rows + job->blockRows - 1) / job->blockRows;
+    size_t begin, end;
+    parallel_chunk(blocks, threadIdx, numThreads, &begin, &end);
+    multiply_rows(job->dst, job->a, job->b, (int)begin * job->blockRows,
+                  min_int((int)end * job->blockRows, rows));
+}
+
+
+void mat_multiply(matrix* c, const matrix* a, const matrix* b, int numThreads)
+{
+    mat_job job = { c, a, b, MAT_BLOCK_ROWS };
+    parallel_run(numThreads, multiply_task, &job); // threads own disjoint rows of C
+}
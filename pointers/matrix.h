@@ -0,0 +1,60 @@
+/**
+ * matrix - a 2D float matrix in one contiguous allocation
+ *
+ * Part 6 of pointers.c shows int marr[10][10] (one block of memory) next to arrays of
+ * pointers to rows. With pointers to rows every row is a separate allocation, and
+ * walking down a column jumps between unrelated cache lines. Here rows live back to
+ * back in a single block, @stride elements apart, so a matrix can also be a view into
+ * a larger one (mat_view) without copying anything.
+ */
+#pragma once
+#include <stddef.h> // size_t
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+typedef struct _matrix {
+    float* data;   // first element of row 0
+    int    rows;
+    int    cols;
+    int    stride; // elements from the start of one row to the next, >= cols
+    float* owned;  // the allocation if this matrix owns it, NULL for views
+} matrix;
+
+
+// allocates an uninitialized rows x cols matrix, rows are padded to 64-byte multiples
+matrix mat_new(int rows, int cols);
+void   mat_free(matrix* m); // frees owned data, views are left untouched
+
+// a rows x cols window starting at (row, col), shares data with @m
+matrix mat_view(const matrix* m, int row, int col, int rows, int cols);
+
+
+static inline float* mat_row(const matrix* m, int row)
+{
+    return m->data + (size_t)row * m->stride;
+}
+static inline float* mat_at(const matrix* m, int row, int col)
+{
+    return m->data + (size_t)row * m->stride + col;
+}
+
+
+void mat_fill(matrix* m, float value);
+
+// dst = src^T, dst must be src->cols x src->rows and must not overlap src
+void mat_transpose_naive(matrix* dst, const matrix* src);
+void mat_transpose(matrix* dst, const matrix* src, int numThreads); // cache-blocked
+
+// c = a * b, c must be a->rows x b->cols and must not overlap a or b
+void mat_multiply_naive(matrix* c, const matrix* a, const matrix* b);
+void mat_multiply(matrix* c, const matrix* a, const matrix* b, int numThreads); // tiled
+
+// numThreads: 1 runs on the calling thread only, <= 0 uses all hardware threads
+
+
+#ifdef __cplusplus
+}
+#endif
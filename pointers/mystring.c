@@ -0,0 +1,68 @@
+/**
+ * String length and copy routines
+ * Uses C99 dialect, so compile with -std=gnu99 or -std=c99
+ */
+#include "mystring.h"
+#include "kernels.h" // kernels.str_nlen, kernels.str_copy
+#include <stdint.h>  // SIZE_MAX
+#include <string.h>  // memcpy
+
+
+
+void my_strcpy1(char* dst, const char* src)
+{
+    while (*src != 0)
+    {
+        *dst = *src;  // copy from src to dst
+
+        ++dst, ++src; // increment pointers
+    }
+    *dst = 0; // the loop stops before the terminator, so write it separately
+}
+
+
+
+void my_strcpy2(char* dst, const char* src)
+{
+    while ((*dst = *src)) // copy from src to dst
+    {
+        ++dst, ++src; // increment pointers
+    }
+}
+
+
+
+void my_strcpy3(char* dst, const char* src)
+{
+    while ((*dst++ = *src++)) // copy from src to dst, increment pointers
+        ;
+}
+
+
+
+
+
+
+size_t my_strlen(const char* s)
+{
+    return kernels.str_nlen(s, SIZE_MAX);
+}
+
+
+char* my_strcpy(char* dst, const char* src)
+{
+    return kernels.str_copy(dst, src);
+}
+
+
+size_t my_strlcpy(char* dst, const char* src, size_t size)
+{
+    size_t len = kernels.str_nlen(src, SIZE_MAX);
+    if (size > 0)
+    {
+        size_t n = len < size - 1 ? len : size - 1;
+        memcpy(dst, src, n);
+        dst[n] = 0;
+    }
+    return len;
+}
@@ -0,0 +1,34 @@
+/**
+ * String length and copy routines
+ * my_strcpy1..3 are the byte-at-a-time examples from the pointers course.
+ * my_strlen/my_strcpy/my_strlcpy go through the kernels table (common/kernels.h),
+ * which picks word-at-a-time, SSE2 or AVX2 code for this CPU at runtime.
+ *
+ * The fast variants only ever read whole aligned words/vectors, which never cross
+ * a page boundary, so reading past the terminator can't fault. It is still reading
+ * outside the string, which address sanitizers will report.
+ */
+#pragma once
+#include <stddef.h> // size_t
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+void my_strcpy1(char* dst, const char* src);
+void my_strcpy2(char* dst, const char* src);
+void my_strcpy3(char* dst, const char* src);
+
+
+// best variant for this CPU:
+size_t my_strlen(const char* s);                // length of @s
+char*  my_strcpy(char* dst, const char* src);   // copies @src with its terminator, returns dst
+// copies at most size-1 chars and always terminates dst (if size > 0)
+// returns strlen(src) like BSD strlcpy, so the copy was truncated if ret >= size
+size_t my_strlcpy(char* dst, const char* src, size_t size);
+
+
+#ifdef __cplusplus
+}
+#endif
@@ -5,6 +5,8 @@
  */
 #include <stdio.h>  // printf
 #include <stdlib.h> // malloc,free,system
+#include "ivector.h" // ivector, iv_new, iv_add, iv_sort
+#include "vector2.h" // vector2
 
 
 
@@ -16,9 +18,11 @@
 
 
 
-typedef struct _vector2 {
-    int x, y;
-} vector2;                   // a simple 8-byte struct definition
+// vector2 is defined in vector2.h:
+//
+//   typedef struct _vector2 {
+//       int x, y;
+//   } vector2;              // a simple 8-byte struct definition
 
 
 char    buffer[128];         // a regular byte buffer
@@ -133,33 +137,8 @@ void part2()
 
 
 
-void my_strcpy1(char* dst, const char* src)
-{
-    while (*src != 0)
-    {
-        *dst = *src;  // copy from src to dst
-
-        ++dst, ++src; // increment pointers
-    }
-}
-
-
-
-void my_strcpy2(char* dst, const char* src)
-{
-    while (*dst = *src) // copy from src to dst
-    {
-        ++dst, ++src; // increment pointers
-    }
-}
-
-
-
-void my_strcpy3(char* dst, const char* src)
-{
-    while (*dst++ = *src++) // copy from src to dst, increment pointers
-        ;
-}
+// my_strcpy1..3 - three ways to write a byte-at-a-time strcpy with pointers -
+// live in mystring.c, next to faster word-at-a-time and SSE2 versions
 
 
 
@@ -300,6 +279,9 @@ void part6()
         ptr2arr[i] = &marr[i];
 
     iptr = (int*) ptr2arr[0]; // getting the pointer to the first array of ptr2arr is easy
+
+    // for large matrices, keep all rows in one allocation and index them with a
+    // row stride instead - see matrix.h for such a type with zero-copy sub-views
 }
 
 
@@ -311,39 +293,14 @@ void part6()
  * Part 7 - Object-oriented programming by using struct pointers
  */
 
-typedef struct _ivector { // an integer vector - a dynamic array
-    int  size;            // that changes its size on demand
-    int  capacity;
-	int* data;
-} ivector;
-
-
-ivector* iv_new() // initializes an existing vector
-{
-    ivector* iv = malloc(sizeof(ivector));
-    iv->size     = 0;   // no elements yet
-    iv->capacity = 0;   // mark the initial capacity
-	iv->data     = NULL;// lazy init array data
-    return iv;
-}
-void iv_free(ivector* iv) // destroys the vector and frees any allocated data
-{
-	if (iv) 
-	{
-		if (iv->data) 
-			free(iv->data); // free array data
-		free(iv);           // destroy this object
-	}
-}
-void iv_add(ivector* iv, int item) // adds an item to the end of the vector
-{
-    if (iv->size == iv->capacity) // grow needed?
-    {
-        iv->capacity += 4 + iv->capacity / 2; // amortized increase
-        iv->data = realloc(iv->data, sizeof(int) * iv->capacity);
-    }
-    iv->data[iv->size++] = item; // append the item
-}
+// the ivector type and its functions live in ivector.h / ivector.c
+// so other modules can reuse them:
+//
+//   typedef struct _ivector {
+//       int  size;
+//       int  capacity;
+//       int* data;
+//   } ivector;
 
 
 
@@ -360,6 +317,17 @@ void part7()
     for (int i = 0; i < iv->size; ++i) // print out added items
         printf("ivec[%d] = %d\n", i, iv->data[i]);
 
+
+    // sorted vectors can be deduplicated and searched in O(log n)
+    iv_add(iv, 20);
+    iv_add(iv, 5);
+    iv_add(iv, 10);
+    iv_sort(iv);             // 5 10 10 20 20 30
+    iv_unique(iv);           // 5 10 20 30
+    printf("unique size = %d\n", iv->size);
+    printf("lower_bound(15) = %d\n", iv_lower_bound(iv, 15)); // index 2 => 20
+    printf("contains(30) = %d\n", iv_contains(iv, 30));
+
     iv_free(iv); // make sure to free any allocated memory
 }
 
@@ -0,0 +1,203 @@
+/**
+ * LSD radix sort for 32-bit and 64-bit integer keys
+ * Uses C99 dialect, so compile with -std=gnu99 or -std=c99
+ */
+#include "radix_sort.h"
+#include "parallel.h" // parallel_run, parallel_chunk
+#include <stdlib.h>   // malloc, free, qsort
+#include <string.h>   // memcpy
+
+
+#define RADIX_BITS  8                 // 8-bit digits: 4 passes for u32, 8 passes for u64
+#define RADIX_SIZE  (1 << RADIX_BITS) // 256 buckets, a histogram fits in 2KB of L1
+#define RADIX_MASK  (RADIX_SIZE - 1)
+#define RADIX_SMALL 64                // below this, insertion sort wins
+#define RADIX_MIN_PER_THREAD (1 << 16) // chunks smaller than this don't pay for a thread
+
+
+typedef struct _radix_job {
+    const void* src;      // keys read during this pass
+    void*       dst;      // keys written during this pass
+    size_t      count;
+    int         keyBytes; // 4 or 8
+    unsigned    shift;    // bit offset of the current digit
+    unsigned    flip;     // 0x80 on the top digit of signed keys, so negatives sort first
+    size_t*     hist;     // [numThreads][RADIX_SIZE] counts, later scatter offsets
+} radix_job;
+
+
+static void radix_count_task(void* arg, int threadIdx, int numThreads)
+{
+    radix_job* job = arg;
+    size_t begin, end;
+    parallel_chunk(job->count, threadIdx, numThreads, &begin, &end);
+
+    size_t hist[RADIX_SIZE] = { 0 }; // count into a local copy to avoid false sharing
+    unsigned shift = job->shift, flip = job->flip;
+    if (job->keyBytes == 4) {
+        const uint32_t* keys = job->src;
+        for (size_t i = begin; i < end; ++i)
+            ++hist[((keys[i] >> shift) & RADIX_MASK) ^ flip];
+    } else {
+        const uint64_t* keys = job->src;
+        for (size_t i = begin; i < end; ++i)
+            ++hist[((keys[i] >> shift) & RADIX_MASK) ^ flip];
+    }
+    memcpy(job->hist + (size_t)threadIdx * RADIX_SIZE, hist, sizeof hist);
+}
+
+
+static void radix_scatter_task(void* arg, int threadIdx, int numThreads)
+{
+    radix_job* job = arg;
+    size_t begin, end;
+    parallel_chunk(job->count, threadIdx, numThreads, &begin, &end);
+
+    size_t offsets[RADIX_SIZE];
+    memcpy(offsets, job->hist + (size_t)threadIdx * RADIX_SIZE, sizeof offsets);
+    unsigned shift = job->shift, flip = job->flip;
+    if (job->keyBytes == 4) {
+        const uint32_t* keys = job->src;
+        uint32_t* dst = job->dst;
+        for (size_t i = begin; i < end; ++i) {
+            uint32_t key = keys[i];
+            dst[offsets[((key >> shift) & RADIX_MASK) ^ flip]++] = key;
+        }
+    } else {
+        const uint64_t* keys = job->src;
+        uint64_t* dst = job->dst;
+        for (size_t i = begin; i < end; ++i) {
+            uint64_t key = keys[i];
+            dst[offsets[((key >> shift) & RADIX_MASK) ^ flip]++] = key;
+        }
+    }
+}
+
+
+// turns per-thread counts into per-thread scatter offsets
+// returns 0 if every key has the same digit, in which case the pass can be skipped
+static int radix_prefix_sum(size_t* hist, int numThreads, size_t count)
+{
+    size_t offset = 0;
+    for (int d = 0; d < RADIX_SIZE; ++d) {
+        size_t total = 0;
+        for (int t = 0; t < numThreads; ++t) {
+            size_t* h = &hist[(size_t)t * RADIX_SIZE + d];
+            size_t c = *h;
+            *h = offset + total;
+            total += c;
+        }
+        if (total == count)
+            return 0;
+        offset += total;
+    }
+    return 1;
+}
+
+
+
+static void insertion_sort_32(uint32_t* keys, size_t count, uint32_t flip)
+{
+    for (size_t i = 1; i < count; ++i) {
+        uint32_t key = keys[i];
+        size_t j = i;
+        for (; j > 0 && (keys[j - 1] ^ flip) > (key ^ flip); --j)
+            keys[j] = keys[j - 1];
+        keys[j] = key;
+    }
+}
+static void insertion_sort_64(uint64_t* keys, size_t count, uint64_t flip)
+{
+    for (size_t i = 1; i < count; ++i) {
+        uint64_t key = keys[i];
+        size_t j = i;
+        for (; j > 0 && (keys[j - 1] ^ flip) > (key ^ flip); --j)
+            keys[j] = keys[j - 1];
+        keys[j] = key;
+    }
+}
+
+
+// qsort comparators, only used if the scratch buffer can't be allocated
+static int cmp_u32(const void* a, const void* b) { uint32_t x = *(const uint32_t*)a, y = *(const uint32_t*)b; return (x > y) - (x < y); }
+static int cmp_i32(const void* a, const void* b) { int32_t  x = *(const int32_t*)a,  y = *(const int32_t*)b;  return (x > y) - (x < y); }
+static int cmp_u64(const void* a, const void* b) { uint64_t x = *(const uint64_t*)a, y = *(const uint64_t*)b; return (x > y) - (x < y); }
+static int cmp_i64(const void* a, const void* b) { int64_t  x = *(const int64_t*)a,  y = *(const int64_t*)b;  return (x > y) - (x < y); }
+
+
+
+static void radix_sort(void* keys, size_t count, int keyBytes, int isSigned, int numThreads)
+{
+    if (count < 2)
+        return;
+
+    if (count < RADIX_SMALL) {
+        if (keyBytes == 4) insertion_sort_32(keys, count, isSigned ? 0x80000000u : 0);
+        else               insertion_sort_64(keys, count, isSigned ? 0x8000000000000000ull : 0);
+        return;
+    }
+
+    if (numThreads <= 0)
+        numThreads = parallel_hw_threads();
+    size_t maxThreads = count / RADIX_MIN_PER_THREAD;
+    if ((size_t)numThreads > maxThreads)
+        numThreads = maxThreads ? (int)maxThreads : 1;
+
+    void*   tmp  = malloc(count * keyBytes);
+    size_t* hist = malloc(sizeof(size_t) * RADIX_SIZE * numThreads);
+    if (!tmp || !hist) {
+        free(tmp);
+        free(hist);
+        qsort(keys, count, keyBytes, keyBytes == 4 ? (isSigned ? cmp_i32 : cmp_u32)
+                                                   : (isSigned ? cmp_i64 : cmp_u64));
+        return;
+    }
+
+    radix_job job;
+    job.src      = keys;
+    job.dst      = tmp;
+    job.count    = count;
+    job.keyBytes = keyBytes;
+    job.hist     = hist;
+
+    int passes = keyBytes * 8 / RADIX_BITS;
+    for (int pass = 0; pass < passes; ++pass)
+    {
+        job.shift = pass * RADIX_BITS;
+        job.flip  = (isSigned && pass == passes - 1) ? (RADIX_SIZE >> 1) : 0;
+
+        parallel_run(numThreads, radix_count_task, &job);
+        if (!radix_prefix_sum(hist, numThreads, count))
+            continue; // all keys share this digit, order is unchanged
+
+        parallel_run(numThreads, radix_scatter_task, &job);
+        void* sorted = job.dst; // ping-pong the buffers
+        job.dst = (void*)job.src;
+        job.src = sorted;
+    }
+
+    if (job.src != keys) // odd number of effective passes: result is in tmp
+        memcpy(keys, job.src, count * keyBytes);
+
+    free(hist);
+    free(tmp);
+}
+
+
+
+void radix_sort_u32(uint32_t* keys, size_t count, int numThreads)
+{
+    radix_sort(keys, count, 4, 0, numThreads);
+}
+void radix_sort_i32(int32_t* keys, size_t count, int numThreads)
+{
+    radix_sort(keys, count, 4, 1, numThreads);
+}
+void radix_sort_u64(uint64_t* keys, size_t count, int numThreads)
+{
+    radix_sort(keys, count, 8, 0, numThreads);
+}
+void radix_sort_i64(int64_t* keys, size_t count, int numThreads)
+{
+    radix_sort(keys, count, 8, 1, numThreads);
+}
@@ -0,0 +1,26 @@
+/**
+ * LSD radix sort for 32-bit and 64-bit integer keys
+ * Each pass builds per-thread digit histograms over a contiguous chunk of keys,
+ * prefix-sums them in (digit, thread) order and lets every thread scatter its own
+ * chunk, which keeps the sort stable and free of any locking.
+ */
+#pragma once
+#include <stddef.h> // size_t
+#include <stdint.h> // int32_t, uint64_t, ...
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+// sorts @keys in ascending order using up to @numThreads threads
+// numThreads <= 0 uses all hardware threads; small inputs always run single-threaded
+void radix_sort_u32(uint32_t* keys, size_t count, int numThreads);
+void radix_sort_i32(int32_t*  keys, size_t count, int numThreads);
+void radix_sort_u64(uint64_t* keys, size_t count, int numThreads);
+void radix_sort_i64(int64_t*  keys, size_t count, int numThreads);
+
+
+#ifdef __cplusplus
+}
+#endif
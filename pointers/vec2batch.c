@@ -0,0 +1,511 @@
+/**
+ * vec2batch - batch math over many 2D vectors in structure-of-arrays layout
+ * Uses C99 dialect, so compile with -std=gnu99 or -std=c99
+ *
+ * Every kernel has the same shape: an SSE2 loop over 4 items per step, followed by a
+ * scalar loop that handles the leftovers (or everything, if SSE2 isn't available).
+ */
+#include "vec2batch.h"
+#include "aligned_mem.h" // mem_aligned_alloc, MEM_ALIGNMENT
+#include "simd.h"        // SIMD_SSE2, SIMD_SSE41
+#include <string.h>      // memcpy
+#include <stdint.h>      // uint32_t
+
+
+
+/**
+ * SSE2 helpers for the integer ops that only exist in SSE4.1
+ */
+#if SIMD_SSE2
+static inline __m128i mullo_epi32(__m128i a, __m128i b)
+{
+#if SIMD_SSE41
+    return _mm_mullo_epi32(a, b);
+#else
+    // multiply even and odd lanes as 64-bit products and keep the low halves
+    __m128i even = _mm_mul_epu32(a, b);
+    __m128i odd  = _mm_mul_epu32(_mm_srli_epi64(a, 32), _mm_srli_epi64(b, 32));
+    return _mm_unpacklo_epi32(_mm_shuffle_epi32(even, _MM_SHUFFLE(0, 0, 2, 0)),
+                              _mm_shuffle_epi32(odd,  _MM_SHUFFLE(0, 0, 2, 0)));
+#endif
+}
+static inline __m128i min_epi32(__m128i a, __m128i b)
+{
+#if SIMD_SSE41
+    return _mm_min_epi32(a, b);
+#else
+    __m128i gt = _mm_cmpgt_epi32(a, b);
+    return _mm_or_si128(_mm_and_si128(gt, b), _mm_andnot_si128(gt, a));
+#endif
+}
+static inline __m128i max_epi32(__m128i a, __m128i b)
+{
+#if SIMD_SSE41
+    return _mm_max_epi32(a, b);
+#else
+    __m128i gt = _mm_cmpgt_epi32(a, b);
+    return _mm_or_si128(_mm_and_si128(gt, a), _mm_andnot_si128(gt, b));
+#endif
+}
+#define LOADI(p)     _mm_loadu_si128((const __m128i*)(p))
+#define STOREI(p, v) _mm_storeu_si128((__m128i*)(p), v)
+#endif
+
+
+// scalar int products wrap like the SIMD ones instead of overflowing (which is UB)
+static inline int mul_wrap(int a, int b)
+{
+    return (int)((uint32_t)a * (uint32_t)b);
+}
+static inline int add_wrap(int a, int b)
+{
+    return (int)((uint32_t)a + (uint32_t)b);
+}
+
+
+// binary ops only pair up the items both inputs have
+static inline int batch_size(int a, int b)
+{
+    return a < b ? a : b;
+}
+
+
+// x and y live in a single allocation: [x0..xN-1, pad][y0..yN-1]
+static void* soa_alloc(int capacity, size_t itemSize, void** y)
+{
+    size_t stride = (capacity * itemSize + MEM_ALIGNMENT - 1) & ~(size_t)(MEM_ALIGNMENT - 1);
+    char* x = mem_aligned_alloc(stride * 2, MEM_ALIGNMENT);
+    *y = x + stride;
+    return x;
+}
+
+
+
+
+
+
+/**
+ * int
+ */
+vec2i_soa* v2i_new(int size)
+{
+    vec2i_soa* v = malloc(sizeof(vec2i_soa));
+    v->size     = 0;
+    v->capacity = 0;
+    v->x        = NULL;
+    v->y        = NULL;
+    v2i_resize(v, size);
+    return v;
+}
+void v2i_free(vec2i_soa* v)
+{
+    if (v)
+    {
+        mem_aligned_free(v->x); // y is part of the same block
+        free(v);
+    }
+}
+void v2i_resize(vec2i_soa* v, int size)
+{
+    if (size > v->capacity)
+    {
+        void* y;
+        int*  x = soa_alloc(size, sizeof(int), &y);
+        if (v->size)
+        {
+            memcpy(x, v->x, sizeof(int) * v->size);
+            memcpy(y, v->y, sizeof(int) * v->size);
+        }
+        mem_aligned_free(v->x);
+        v->x = x;
+        v->y = y;
+        v->capacity = size;
+    }
+    v->size = size;
+}
+
+
+void v2i_from_aos(vec2i_soa* out, const vector2* aos, int count)
+{
+    v2i_resize(out, count);
+    int i = 0;
+#if SIMD_SSE2
+    for (; i + 4 <= count; i += 4)
+    {
+        __m128 a = _mm_castsi128_ps(LOADI(&aos[i]));     // x0 y0 x1 y1
+        __m128 b = _mm_castsi128_ps(LOADI(&aos[i + 2])); // x2 y2 x3 y3
+        STOREI(&out->x[i], _mm_castps_si128(_mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0))));
+        STOREI(&out->y[i], _mm_castps_si128(_mm_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1))));
+    }
+#endif
+    for (; i < count; ++i)
+    {
+        out->x[i] = aos[i].x;
+        out->y[i] = aos[i].y;
+    }
+}
+void v2i_to_aos(vector2* aos, const vec2i_soa* v)
+{
+    int n = v->size, i = 0;
+#if SIMD_SSE2
+    for (; i + 4 <= n; i += 4)
+    {
+        __m128i x = LOADI(&v->x[i]);
+        __m128i y = LOADI(&v->y[i]);
+        STOREI(&aos[i],     _mm_unpacklo_epi32(x, y)); // x0 y0 x1 y1
+        STOREI(&aos[i + 2], _mm_unpackhi_epi32(x, y)); // x2 y2 x3 y3
+    }
+#endif
+    for (; i < n; ++i)
+    {
+        aos[i].x = v->x[i];
+        aos[i].y = v->y[i];
+    }
+}
+
+
+void v2i_add(vec2i_soa* out, const vec2i_soa* a, const vec2i_soa* b)
+{
+    int n = batch_size(a->size, b->size), i = 0;
+    v2i_resize(out, n);
+#if SIMD_SSE2
+    for (; i + 4 <= n; i += 4)
+    {
+        STOREI(&out->x[i], _mm_add_epi32(LOADI(&a->x[i]), LOADI(&b->x[i])));
+        STOREI(&out->y[i], _mm_add_epi32(LOADI(&a->y[i]), LOADI(&b->y[i])));
+    }
+#endif
+    for (; i < n; ++i)
+    {
+        out->x[i] = add_wrap(a->x[i], b->x[i]);
+        out->y[i] = add_wrap(a->y[i], b->y[i]);
+    }
+}
+
+
+void v2i_scale(vec2i_soa* out, const vec2i_soa* a, int s)
+{
+    int n = a->size, i = 0;
+    v2i_resize(out, n);
+#if SIMD_SSE2
+    __m128i vs = _mm_set1_epi32(s);
+    for (; i + 4 <= n; i += 4)
+    {
+        STOREI(&out->x[i], mullo_epi32(LOADI(&a->x[i]), vs));
+        STOREI(&out->y[i], mullo_epi32(LOADI(&a->y[i]), vs));
+    }
+#endif
+    for (; i < n; ++i)
+    {
+        out->x[i] = mul_wrap(a->x[i], s);
+        out->y[i] = mul_wrap(a->y[i], s);
+    }
+}
+
+
+void v2i_dot(int* out, const vec2i_soa* a, const vec2i_soa* b)
+{
+    int n = batch_size(a->size, b->size), i = 0;
+#if SIMD_SSE2
+    for (; i + 4 <= n; i += 4)
+    {
+        __m128i xx = mullo_epi32(LOADI(&a->x[i]), LOADI(&b->x[i]));
+        __m128i yy = mullo_epi32(LOADI(&a->y[i]), LOADI(&b->y[i]));
+        STOREI(&out[i], _mm_add_epi32(xx, yy));
+    }
+#endif
+    for (; i < n; ++i)
+        out[i] = add_wrap(mul_wrap(a->x[i], b->x[i]), mul_wrap(a->y[i], b->y[i]));
+}
+
+
+void v2i_length2(int* out, const vec2i_soa* a)
+{
+    v2i_dot(out, a, a);
+}
+
+
+void v2i_bounds(const vec2i_soa* a, vector2* min, vector2* max)
+{
+    int n = a->size, i = 0;
+    if (n == 0)
+    {
+        vector2 zero = { 0, 0 };
+        *min = *max = zero;
+        return;
+    }
+    vector2 lo = { a->x[0], a->y[0] };
+    vector2 hi = lo;
+#if SIMD_SSE2
+    if (n >= 4)
+    {
+        __m128i minx = LOADI(&a->x[0]), maxx = minx;
+        __m128i miny = LOADI(&a->y[0]), maxy = miny;
+        for (i = 4; i + 4 <= n; i += 4)
+        {
+            __m128i x = LOADI(&a->x[i]);
+            __m128i y = LOADI(&a->y[i]);
+            minx = min_epi32(minx, x); maxx = max_epi32(maxx, x);
+            miny = min_epi32(miny, y); maxy = max_epi32(maxy, y);
+        }
+        int t[4][4];
+        STOREI(t[0], minx); STOREI(t[1], maxx); STOREI(t[2], miny); STOREI(t[3], maxy);
+        for (int k = 0; k < 4; ++k) // reduce the 4 lanes
+        {
+            if (t[0][k] < lo.x) lo.x = t[0][k];
+            if (t[1][k] > hi.x) hi.x = t[1][k];
+            if (t[2][k] < lo.y) lo.y = t[2][k];
+            if (t[3][k] > hi.y) hi.y = t[3][k];
+        }
+    }
+#endif
+    for (; i < n; ++i)
+    {
+        if (a->x[i] < lo.x) lo.x = a->x[i];
+        if (a->x[i] > hi.x) hi.x = a->x[i];
+        if (a->y[i] < lo.y) lo.y = a->y[i];
+        if (a->y[i] > hi.y) hi.y = a->y[i];
+    }
+    *min = lo;
+    *max = hi;
+}
+
+
+void v2i_transform(vec2i_soa* out, const vec2i_soa* a, const int m[4])
+{
+    int n = a->size, i = 0;
+    v2i_resize(out, n);
+#if SIMD_SSE2
+    __m128i m0 = _mm_set1_epi32(m[0]), m1 = _mm_set1_epi32(m[1]);
+    __m128i m2 = _mm_set1_epi32(m[2]), m3 = _mm_set1_epi32(m[3]);
+    for (; i + 4 <= n; i += 4)
+    {
+        __m128i x = LOADI(&a->x[i]);
+        __m128i y = LOADI(&a->y[i]);
+        STOREI(&out->x[i], _mm_add_epi32(mullo_epi32(m0, x), mullo_epi32(m1, y)));
+        STOREI(&out->y[i], _mm_add_epi32(mullo_epi32(m2, x), mullo_epi32(m3, y)));
+    }
+#endif
+    for (; i < n; ++i)
+    {
+        int x = a->x[i], y = a->y[i];
+        out->x[i] = add_wrap(mul_wrap(m[0], x), mul_wrap(m[1], y));
+        out->y[i] = add_wrap(mul_wrap(m[2], x), mul_wrap(m[3], y));
+    }
+}
+
+
+
+
+
+
+/**
+ * float
+ */
+vec2f_soa* v2f_new(int size)
+{
+    vec2f_soa* v = malloc(sizeof(vec2f_soa));
+    v->size     = 0;
+    v->capacity = 0;
+    v->x        = NULL;
+    v->y        = NULL;
+    v2f_resize(v, size);
+    return v;
+}
+void v2f_free(vec2f_soa* v)
+{
+    if (v)
+    {
+        mem_aligned_free(v->x);
+        free(v);
+    }
+}
+void v2f_resize(vec2f_soa* v, int size)
+{
+    if (size > v->capacity)
+    {
+        void*  y;
+        float* x = soa_alloc(size, sizeof(float), &y);
+        if (v->size)
+        {
+            memcpy(x, v->x, sizeof(float) * v->size);
+            memcpy(y, v->y, sizeof(float) * v->size);
+        }
+        mem_aligned_free(v->x);
+        v->x = x;
+        v->y = y;
+        v->capacity = size;
+    }
+    v->size = size;
+}
+
+
+void v2f_from_aos(vec2f_soa* out, const vector2f* aos, int count)
+{
+    v2f_resize(out, count);
+    int i = 0;
+#if SIMD_SSE2
+    for (; i + 4 <= count; i += 4)
+    {
+        __m128 a = _mm_loadu_ps(&aos[i].x);     // x0 y0 x1 y1
+        __m128 b = _mm_loadu_ps(&aos[i + 2].x); // x2 y2 x3 y3
+        _mm_storeu_ps(&out->x[i], _mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0)));
+        _mm_storeu_ps(&out->y[i], _mm_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1)));
+    }
+#endif
+    for (; i < count; ++i)
+    {
+        out->x[i] = aos[i].x;
+        out->y[i] = aos[i].y;
+    }
+}
+void v2f_to_aos(vector2f* aos, const vec2f_soa* v)
+{
+    int n = v->size, i = 0;
+#if SIMD_SSE2
+    for (; i + 4 <= n; i += 4)
+    {
+        __m128 x = _mm_loadu_ps(&v->x[i]);
+        __m128 y = _mm_loadu_ps(&v->y[i]);
+        _mm_storeu_ps(&aos[i].x,     _mm_unpacklo_ps(x, y));
+        _mm_storeu_ps(&aos[i + 2].x, _mm_unpackhi_ps(x, y));
+    }
+#endif
+    for (; i < n; ++i)
+    {
+        aos[i].x = v->x[i];
+        aos[i].y = v->y[i];
+    }
+}
+
+
+void v2f_add(vec2f_soa* out, const vec2f_soa* a, const vec2f_soa* b)
+{
+    int n = batch_size(a->size, b->size), i = 0;
+    v2f_resize(out, n);
+#if SIMD_SSE2
+    for (; i + 4 <= n; i += 4)
+    {
+        _mm_storeu_ps(&out->x[i], _mm_add_ps(_mm_loadu_ps(&a->x[i]), _mm_loadu_ps(&b->x[i])));
+        _mm_storeu_ps(&out->y[i], _mm_add_ps(_mm_loadu_ps(&a->y[i]), _mm_loadu_ps(&b->y[i])));
+    }
+#endif
+    for (; i < n; ++i)
+    {
+        out->x[i] = a->x[i] + b->x[i];
+        out->y[i] = a->y[i] + b->y[i];
+    }
+}
+
+
+void v2f_scale(vec2f_soa* out, const vec2f_soa* a, float s)
+{
+    int n = a->size, i = 0;
+    v2f_resize(out, n);
+#if SIMD_SSE2
+    __m128 vs = _mm_set1_ps(s);
+    for (; i + 4 <= n; i += 4)
+    {
+        _mm_storeu_ps(&out->x[i], _mm_mul_ps(_mm_loadu_ps(&a->x[i]), vs));
+        _mm_storeu_ps(&out->y[i], _mm_mul_ps(_mm_loadu_ps(&a->y[i]), vs));
+    }
+#endif
+    for (; i < n; ++i)
+    {
+        out->x[i] = a->x[i] * s;
+        out->y[i] = a->y[i] * s;
+    }
+}
+
+
+void v2f_dot(float* out, const vec2f_soa* a, const vec2f_soa* b)
+{
+    int n = batch_size(a->size, b->size), i = 0;
+#if SIMD_SSE2
+    for (; i + 4 <= n; i += 4)
+    {
+        __m128 xx = _mm_mul_ps(_mm_loadu_ps(&a->x[i]), _mm_loadu_ps(&b->x[i]));
+        __m128 yy = _mm_mul_ps(_mm_loadu_ps(&a->y[i]), _mm_loadu_ps(&b->y[i]));
+        _mm_storeu_ps(&out[i], _mm_add_ps(xx, yy));
+    }
+#endif
+    for (; i < n; ++i)
+        out[i] = a->x[i] * b->x[i] + a->y[i] * b->y[i];
+}
+
+
+void v2f_length2(float* out, const vec2f_soa* a)
+{
+    v2f_dot(out, a, a);
+}
+
+
+void v2f_bounds(const vec2f_soa* a, vector2f* min, vector2f* max)
+{
+    int n = a->size, i = 0;
+    if (n == 0)
+    {
+        vector2f zero = { 0, 0 };
+        *min = *max = zero;
+        return;
+    }
+    vector2f lo = { a->x[0], a->y[0] };
+    vector2f hi = lo;
+#if SIMD_SSE2
+    if (n >= 4)
+    {
+        __m128 minx = _mm_loadu_ps(&a->x[0]), maxx = minx;
+        __m128 miny = _mm_loadu_ps(&a->y[0]), maxy = miny;
+        for (i = 4; i + 4 <= n; i += 4)
+        {
+            __m128 x = _mm_loadu_ps(&a->x[i]);
+            __m128 y = _mm_loadu_ps(&a->y[i]);
+            minx = _mm_min_ps(minx, x); maxx = _mm_max_ps(maxx, x);
+            miny = _mm_min_ps(miny, y); maxy = _mm_max_ps(maxy, y);
+        }
+        float t[4][4];
+        _mm_storeu_ps(t[0], minx); _mm_storeu_ps(t[1], maxx);
+        _mm_storeu_ps(t[2], miny); _mm_storeu_ps(t[3], maxy);
+        for (int k = 0; k < 4; ++k)
+        {
+            if (t[0][k] < lo.x) lo.x = t[0][k];
+            if (t[1][k] > hi.x) hi.x = t[1][k];
+            if (t[2][k] < lo.y) lo.y = t[2][k];
+            if (t[3][k] > hi.y) hi.y = t[3][k];
+        }
+    }
+#endif
+    for (; i < n; ++i)
+    {
+        if (a->x[i] < lo.x) lo.x = a->x[i];
+        if (a->x[i] > hi.x) hi.x = a->x[i];
+        if (a->y[i] < lo.y) lo.y = a->y[i];
+        if (a->y[i] > hi.y) hi.y = a->y[i];
+    }
+    *min = lo;
+    *max = hi;
+}
+
+
+void v2f_transform(vec2f_soa* out, const vec2f_soa* a, const float m[4])
+{
+    int n = a->size, i = 0;
+    v2f_resize(out, n);
+#if SIMD_SSE2
+    __m128 m0 = _mm_set1_ps(m[0]), m1 = _mm_set1_ps(m[1]);
+    __m128 m2 = _mm_set1_ps(m[2]), m3 = _mm_set1_ps(m[3]);
+    for (; i + 4 <= n; i += 4)
+    {
+        __m128 x = _mm_loadu_ps(&a->x[i]);
+        __m128 y = _mm_loadu_ps(&a->y[i]);
+        _mm_storeu_ps(&out->x[i], _mm_add_ps(_mm_mul_ps(m0, x), _mm_mul_ps(m1, y)));
+        _mm_storeu_ps(&out->y[i], _mm_add_ps(_mm_mul_ps(m2, x), _mm_mul_ps(m3, y)));
+    }
+#endif
+    for (; i < n; ++i)
+    {
+        float x = a->x[i], y = a->y[i];
+        out->x[i] = m[0] * x + m[1] * y;
+        out->y[i] = m[2] * x + m[3] * y;
+    }
+}
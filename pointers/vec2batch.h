@@ -0,0 +1,66 @@
+/**
+ * vec2batch - batch math over many 2D vectors in structure-of-arrays layout
+ *
+ * An array of vector2 (AoS) stores x0 y0 x1 y1 x2 y2 ..., so a SIMD register loaded
+ * from it holds a mix of x and y. Storing all x's and all y's in separate arrays (SoA)
+ * lets every kernel load 4 x's and 4 y's at once and apply the same operation to them.
+ *
+ * Kernels use SSE2 where available and plain loops elsewhere. Integer products wrap
+ * modulo 2^32 in both code paths, so keep coordinates below 2^15 for exact dot/length2.
+ * Output containers are resized to fit, and may be the same as an input. Binary ops
+ * process min(a->size, b->size) items; dot/length2 write that many to @out.
+ */
+#pragma once
+#include "vector2.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+typedef struct _vec2i_soa {
+    int  size;
+    int  capacity;
+    int* x;            // x[size], 64-byte aligned
+    int* y;            // y[size], 64-byte aligned
+} vec2i_soa;
+
+typedef struct _vec2f_soa {
+    int    size;
+    int    capacity;
+    float* x;
+    float* y;
+} vec2f_soa;
+
+
+vec2i_soa* v2i_new(int size);                 // allocates @size uninitialized vectors
+void v2i_free(vec2i_soa* v);
+void v2i_resize(vec2i_soa* v, int size);      // existing items are kept
+void v2i_from_aos(vec2i_soa* out, const vector2* aos, int count);
+void v2i_to_aos(vector2* aos, const vec2i_soa* v); // @aos must hold v->size items
+
+void v2i_add(vec2i_soa* out, const vec2i_soa* a, const vec2i_soa* b);  // out = a + b
+void v2i_scale(vec2i_soa* out, const vec2i_soa* a, int s);             // out = a * s
+void v2i_dot(int* out, const vec2i_soa* a, const vec2i_soa* b);        // out[i] = a.x*b.x + a.y*b.y
+void v2i_length2(int* out, const vec2i_soa* a);                        // out[i] = a.x*a.x + a.y*a.y
+void v2i_bounds(const vec2i_soa* a, vector2* min, vector2* max);       // {0, 0} if a is empty
+void v2i_transform(vec2i_soa* out, const vec2i_soa* a, const int m[4]);// out = [m0 m1; m2 m3] * a
+
+
+vec2f_soa* v2f_new(int size);
+void v2f_free(vec2f_soa* v);
+void v2f_resize(vec2f_soa* v, int size);
+void v2f_from_aos(vec2f_soa* out, const vector2f* aos, int count);
+void v2f_to_aos(vector2f* aos, const vec2f_soa* v);
+
+void v2f_add(vec2f_soa* out, const vec2f_soa* a, const vec2f_soa* b);
+void v2f_scale(vec2f_soa* out, const vec2f_soa* a, float s);
+void v2f_dot(float* out, const vec2f_soa* a, const vec2f_soa* b);
+void v2f_length2(float* out, const vec2f_soa* a);
+void v2f_bounds(const vec2f_soa* a, vector2f* min, vector2f* max);
+void v2f_transform(vec2f_soa* out, const vec2f_soa* a, const float m[4]);
+
+
+#ifdef __cplusplus
+}
+#endif
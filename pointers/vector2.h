@@ -0,0 +1,23 @@
+/**
+ * vector2 - a simple 2D vector, used in Parts 3 and 4 of pointers.c
+ */
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+typedef struct _vector2 {
+    int x, y;
+} vector2;                   // a simple 8-byte struct definition
+
+
+typedef struct _vector2f {
+    float x, y;
+} vector2f;                  // the same with floats
+
+
+#ifdef __cplusplus
+}
+#endif
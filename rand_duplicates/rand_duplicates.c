@@ -5,23 +5,27 @@
 */
 #include <stdlib.h> // system("pause")
 #include <stdio.h>  // printf
-#include <string.h> // memset
-#include <limits.h> // INT_MAX
+#include <string.h> // strcmp
+#include "kernels.h" // kernels.minmax_i32, kernels.histogram_i32, kernels.hash_u32
+#include "rng.h"     // rng_fill_range_i32
+#include "bench.h"   // bench_begin, bench_run, bench_end
+#include "trace.h"   // trace_zone_begin, trace_progress_start, trace_start
 
 
 // optimized histogram approach, Theta(3n)
 static int hist_duplicates(int* values, int count)
 {
-	int min = INT_MAX, max = 0;
+	if (count <= 0)
+		return 0;
+	trace_zone zone = trace_zone_begin("hist_duplicates");
 
-	// find the min-max values to calculate the psan
-	for (int i = 0; i < count; ++i)
-	{
-		int value = values[i];
-		if (value < min)      min = value;
-		else if (value > max) max = value;
-	}
+	// find the min-max values to calculate the span
+	int min, max;
+	trace_zone step = trace_zone_begin("minmax");
+	kernels.minmax_i32(values, count, &min, &max);
+	trace_zone_end(step);
 	int size = (max - min) + 1; // the number of elements in the histogram
+	trace_counter("histogram size", size);
 
 
 								// initialize histogram and set all elements to 0
@@ -30,27 +34,76 @@ static int hist_duplicates(int* values, int count)
 		histogram[i] = 0;
 
 
-	// construct the histogram and use it to find duplicate values
-	int duplicates = 0;
-	for (int i = 0; i < count; ++i)
+	// construct the histogram; the first value of every bin is unique,
+	// all others are duplicates
+	step = trace_zone_begin("histogram");
+	kernels.histogram_i32(histogram, size, values, count, min);
+	trace_zone_end(step);
+	step = trace_zone_begin("count unique");
+	int unique = 0;
+	for (int i = 0; i < size; ++i)
+		if (histogram[i] > 0)
+			++unique;
+	trace_zone_end(step);
+
+	free(histogram);
+	trace_zone_end(zone);
+	return count - unique;
+}
+
+
+// hash set approach, Theta(n) with memory for 2n values instead of the whole span,
+// so it suits sparse values where the histogram would be mostly empty
+static int hash_duplicates(const int* values, int count)
+{
+	if (count <= 0)
+		return 0;
+	trace_zone zone = trace_zone_begin("hash_duplicates");
+
+	int capacity = 1; // a power of 2 at least twice the count keeps the probes short
+	while (capacity < 2 * count)
+		capacity <<= 1;
+	int* keys = malloc(sizeof(int) * capacity);
+	unsigned char* used = calloc(capacity, 1);
+
+	// hash a batch at a time with the SIMD kernel, then insert it; linear probing
+	// finds either the same value (a duplicate) or an empty slot (a unique value)
+	#define HASH_BATCH 1024
+	uint32_t hashes[HASH_BATCH];
+	int unique = 0;
+	for (int i = 0; i < count; i += HASH_BATCH)
 	{
-		// increase histogram value at the specified index
-		int normalizedIndex = values[i] - min;
-		if (++histogram[normalizedIndex] > 1) // if histogram value at index > 1
-			++duplicates;                     // there's a duplicate
+		int n = count - i < HASH_BATCH ? count - i : HASH_BATCH;
+		kernels.hash_u32(hashes, (const uint32_t*)values + i, n);
+		for (int j = 0; j < n; ++j)
+		{
+			int value = values[i + j];
+			unsigned slot = hashes[j] & (capacity - 1);
+			while (used[slot] && keys[slot] != value)
+				slot = (slot + 1) & (capacity - 1);
+			if (!used[slot])
+			{
+				used[slot] = 1;
+				keys[slot] = value;
+				++unique;
+			}
+		}
 	}
 
-	free(histogram);
-	return duplicates;
+	free(keys);
+	free(used);
+	trace_zone_end(zone);
+	return count - unique;
 }
 
 
 // classic O(n^2) approach;
 static int bubble_duplicates(int* values, int count)
 {
-	// this is so slow we might as well report progress
-	printf("%3d%%", 0);
-	int percentstep = count / 100;
+	// this is so slow we might as well report progress, from a sampler thread
+	// so the loop only stores its index
+	trace_zone zone = trace_zone_begin("bubble_duplicates");
+	trace_progress* progress = trace_progress_start("bubble_duplicates progress", count);
 
 	int duplicates = 0;
 	for (int i = 0; i < count; ++i)
@@ -64,30 +117,92 @@ static int bubble_duplicates(int* values, int count)
 				break; // stop here to avoid reading more than 1 duplicate at a time
 			}
 		}
-		if (i % percentstep == 0)
-			printf("\b\b\b\b%3d%%", (i*100)/count);
+		trace_progress_set(progress, i + 1);
 	}
-	printf("\b\b\b\b"); // erase 100%
+	trace_progress_stop(progress);
+	trace_zone_end(zone);
 	return duplicates;
 }
 
+
+typedef struct _dup_bench {
+	int* values;
+	int  count;
+	int  duplicates;
+} dup_bench;
+
+static void bench_hist(void* arg)
+{
+	dup_bench* b = arg;
+	b->duplicates = hist_duplicates(b->values, b->count);
+}
+
+static void bench_hash(void* arg)
+{
+	dup_bench* b = arg;
+	b->duplicates = hash_duplicates(b->values, b->count);
+}
+
+
+// `make bench`: hist_duplicates with dense values (span == count) and the sparse
+// span main() uses, where clearing the 64MB histogram dominates, and few bins, where
+// repeated bins chain their increments; hash_duplicates on dense and sparse
+static int run_benchmarks(void)
+{
+	static const struct { const char* name; void (*run)(void*); int count, span; } cases[] = {
+		{ "hist_duplicates 64K dense",   bench_hist, 1 << 16, 1 << 16 },
+		{ "hist_duplicates 500K dense",  bench_hist, 500000,  500000  },
+		{ "hist_duplicates 500K sparse", bench_hist, 500000,  1 << 24 },
+		{ "hist_duplicates 4M dense",    bench_hist, 1 << 22, 1 << 22 },
+		{ "hist_duplicates 4M 256 bins", bench_hist, 1 << 22, 256     },
+		{ "hash_duplicates 500K dense",  bench_hash, 500000,  500000  },
+		{ "hash_duplicates 500K sparse", bench_hash, 500000,  1 << 24 },
+	};
+	bench_begin("rand_duplicates");
+	for (int i = 0; i < (int)(sizeof cases / sizeof cases[0]); ++i)
+	{
+		dup_bench b = { malloc(sizeof(int) * cases[i].count), cases[i].count, 0 };
+		rng_fill_range_i32(b.values, b.count, 0, cases[i].span - 1, 2015, 0);
+		bench_run(cases[i].name, cases[i].run, &b, sizeof(int) * (double)b.count);
+		free(b.values);
+	}
+	return bench_end(); // number of regressions against BENCH_BASELINE
+}
+
+
 int main(int argc, char** argv)
 {
+	// checks every SIMD level this CPU supports against the plain C kernels
+	if (argc > 1 && strcmp(argv[1], "--selftest") == 0)
+		return kernels_selftest(1) ? 1 : 0;
+	if (argc > 1 && strcmp(argv[1], "--bench") == 0)
+		return run_benchmarks() ? 1 : 0;
+	printf("Kernels: %s\n", cpu_level_name(kernels_init()));
+	trace_start(NULL); // TRACE=file.json writes a Chrome trace of the run
+
 	#define NUM_ELEMENTS 500000
+	#define VALUE_SPAN (1 << 24) // the histogram needs a counter for every possible value, the rng has no limit
 	static int values[NUM_ELEMENTS];
-	for (int i = 0; i < NUM_ELEMENTS; ++i)
-		values[i] = rand();
+	// the same values on every run and platform, unlike rand() whose RAND_MAX
+	// is 32767 on Windows and 2^31-1 with glibc
+	rng_fill_range_i32(values, NUM_ELEMENTS, 0, VALUE_SPAN - 1, 2015, 0);
 
 	// find duplicates using the histogram method
 	printf("Histogram Duplicates: ");
 	int duplicates1 = hist_duplicates(values, NUM_ELEMENTS);
 	printf("%d / %d (%.2g%%)\n", duplicates1, NUM_ELEMENTS, 100.f * duplicates1 / NUM_ELEMENTS);
 
+	// a hash set only needs memory for the values, not for the whole span
+	printf("Hash Duplicates:      ");
+	int duplicates3 = hash_duplicates(values, NUM_ELEMENTS);
+	printf("%d / %d (%.2g%%)\n", duplicates3, NUM_ELEMENTS, 100.f * duplicates3 / NUM_ELEMENTS);
+
 	// compared against a classical O(n^2) approach
 	printf("Bubble Duplicates:    ");
 	int duplicates2 = bubble_duplicates(values, NUM_ELEMENTS);
 	printf("%d / %d (%.2g%%)\n", duplicates2, NUM_ELEMENTS, 100.f * duplicates2 / NUM_ELEMENTS);
 
+	trace_stop();
 	system("pause");
 	return 0;
 }
\ No newline at end of file
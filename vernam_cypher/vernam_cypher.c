@@ -5,6 +5,12 @@
 */
 #include <stdlib.h>
 #include <stdio.h>
+#include <string.h> // strlen, strcmp
+#include <time.h>   // time
+#include "kernels.h" // kernels.xor_bytes, kernels.hex_encode
+#include "rng.h"     // rng_fill_bytes
+#include "bench.h"   // bench_begin, bench_run, bench_end
+#include "trace.h"   // trace_zone_begin, trace_zone_end, trace_start
 
 
 int get_input(char* buffer, int maxCount)
@@ -12,36 +18,126 @@ int get_input(char* buffer, int maxCount)
 	fgets(buffer, maxCount, stdin); // read up to maxCount chars from console
 	fflush(stdin);                  // flush standard input (if some chars were left over)
 	int size = strlen(buffer);      // get the length of the input string
-	if (buffer[size - 1] == '\n')
+	if (size > 0 && buffer[size - 1] == '\n')
 		buffer[--size] = '\0';      // remove trailing \n
 	return size;
 }
 
 
-int vernam_cypher(int argc, char** argv)
+typedef struct _cypher_bench {
+	const kernel_table* k;
+	char*  text;
+	char*  pad;
+	char*  hex;
+	size_t size;
+} cypher_bench;
+
+static void bench_xor(void* arg)
+{
+	cypher_bench* b = arg;
+	b->k->xor_bytes(b->text, b->text, b->pad, b->size); // encode in place, like main()
+}
+
+static void bench_hex(void* arg)
+{
+	cypher_bench* b = arg;
+	b->k->hex_encode(b->hex, b->text, b->size);
+}
+
+
+// `make bench`: the cypher loop at every SIMD level, from one line of text to 16MB
+static int run_benchmarks(void)
 {
+	static const size_t sizes[] = { 128, 64 << 10, 16 << 20 };
+	static const char* sizeNames[] = { "128B", "64KB", "16MB" };
+	size_t maxSize = sizes[2];
+	char* text = malloc(maxSize);
+	char* pad = malloc(maxSize);
+	char* hex = malloc(2 * maxSize);
+	rng_fill_bytes(text, maxSize, 1, 0);
+	rng_fill_bytes(pad, maxSize, 2, 0);
+
+	bench_begin("vernam_cypher");
+	for (int level = CPU_SCALAR; level < CPU_LEVEL_COUNT; ++level)
+	{
+		const kernel_table* k = kernels_for_level((cpu_level)level);
+		if (!k)
+			continue;
+		for (int i = 0; i < 3; ++i)
+		{
+			cypher_bench b = { k, text, pad, hex, sizes[i] };
+			char name[64];
+			sprintf(name, "xor_bytes %s %s", cpu_level_name(level), sizeNames[i]);
+			bench_run(name, bench_xor, &b, (double)b.size);
+			sprintf(name, "hex_encode %s %s", cpu_level_name(level), sizeNames[i]);
+			bench_run(name, bench_hex, &b, (double)b.size);
+		}
+	}
+	free(text);
+	free(pad);
+	free(hex);
+	return bench_end(); // number of regressions against BENCH_BASELINE
+}
+
+
+int main(int argc, char** argv)
+{
+	// checks every SIMD level this CPU supports against the plain C kernels
+	if (argc > 1 && strcmp(argv[1], "--selftest") == 0)
+		return kernels_selftest(1) ? 1 : 0;
+	if (argc > 1 && strcmp(argv[1], "--bench") == 0)
+		return run_benchmarks() ? 1 : 0;
+
 	char input[128] = { 0 };
 	char cypher[128] = { 0 };
+	char hex[2 * sizeof input];
+	trace_start(NULL); // TRACE=file.json writes a Chrome trace of the run
 
 	printf("Text to Encode:  ");
 	int inputSize = get_input(input, sizeof input);
-	printf("Encoding Cypher: ");
+	printf("Encoding Cypher (empty for a random pad): ");
 	int cypherSize = get_input(cypher, sizeof cypher);
 
+	// a pad as long as the input; xoshiro is predictable, so this is fine for
+	// trying the cypher out but a real one-time pad needs a cryptographic source
+	if (cypherSize == 0)
+	{
+		cypherSize = inputSize;
+		trace_zone zone = trace_zone_begin("random pad");
+		rng_fill_bytes(cypher, cypherSize, (uint64_t)time(NULL), 1);
+		trace_zone_end(zone);
+		kernels.hex_encode(hex, cypher, cypherSize);
+		printf("Random Pad:   ");
+		for (int i = 0; i < cypherSize; ++i) printf("0x%.2s ", hex + i * 2);
+		printf("\n");
+	}
+
+	// a shorter cypher is repeated over the input, instead of leaving the rest
+	// xor-ed with the zeros after it, which would print that part in clear
+	for (int i = cypherSize; i < inputSize; ++i)
+		cypher[i] = cypher[i % cypherSize];
+
 	// encode the input with a simple xor
-	for (int i = 0; i < inputSize; ++i)
-		input[i] ^= cypher[i];
+	trace_counter("text bytes", inputSize);
+	trace_zone zone = trace_zone_begin("encode");
+	kernels.xor_bytes(input, input, cypher, inputSize);
+	trace_zone_end(zone);
 
-	// print encoded text as HEX
+	// print encoded text as HEX, two digits per byte
 	printf("Encoded HEX:  ");
-	for (int i = 0; i < inputSize; ++i) printf("0x%02x ", input[i]);
+	zone = trace_zone_begin("hex_encode");
+	kernels.hex_encode(hex, input, inputSize);
+	trace_zone_end(zone);
+	for (int i = 0; i < inputSize; ++i) printf("0x%.2s ", hex + i * 2);
 	printf("\n");
 
 	// decode input with the same cypher
-	for (int i = 0; i < inputSize; ++i)
-		input[i] ^= cypher[i];
+	zone = trace_zone_begin("decode");
+	kernels.xor_bytes(input, input, cypher, inputSize);
+	trace_zone_end(zone);
 	printf("Decoded Text: '%.*s'\n", inputSize, input);
 
+	trace_stop();
 	system("pause");
 	return 0;
 }
\ No newline at end of file